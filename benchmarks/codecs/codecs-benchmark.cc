@@ -0,0 +1,315 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file codecs-benchmark.cc
+ * @brief Throughput of the VLQ API over value distributions and array sizes.
+ *
+ * BM_VlqDecodeThenSum and BM_VlqSumArray compare summing a decoded array
+ * with the fused kernel, which never writes the values to memory.
+ * BM_Leb128EncodeArray and BM_Leb128DecodeArray run the same kernels on the
+ * LSB-first format. BM_VlqCountValues counts the values of a buffer, the
+ * first pass of vlqDecodeArrayUntilEnd(). BM_VlqEncodeFrame and
+ * BM_VlqDecodeFrame add the CRC32C of vlq-frame.h to the array codec.
+ * BM_VlqEncodeAppend encodes into a new std::vector each time, growth
+ * included.
+ *
+ * Every benchmark takes two arguments: the distribution (see Distribution)
+ * and the number of values, from 1K (L1-resident) to 16M (DRAM-sized).
+ * items_per_second is values/s, bytes_per_second is encoded bytes/s.
+ *
+ * Run with:
+ *   bazel run -c opt //benchmarks/codecs:codecs-benchmark
+ *
+ * and export the results to compare revisions with:
+ *   bazel run -c opt //benchmarks/codecs:codecs-benchmark -- \
+ *     --benchmark_out=codecs.json --benchmark_out_format=json
+ */
+
+// standard includes
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+// third-party includes
+#include <benchmark/benchmark.h>
+
+// project includes
+#include "vlq-aggregate.h"
+#include "vlq-frame.h"
+#include "vlq.h"
+
+namespace {
+
+enum Distribution : int64_t {
+  kOneByte,       ///< Values < 2^7.
+  kFiveByte,      ///< Values >= 2^28.
+  kUniform,       ///< Encoded length uniform over 1 to 5 bytes.
+  kZipfian,       ///< Zipf(1) ranks over 2^20 values.
+  kSortedDeltas,  ///< Gaps between sorted random values.
+};
+
+constexpr const char* kDistributionNames[] = {"one-byte", "five-byte",
+                                              "uniform", "zipfian",
+                                              "sorted-deltas"};
+
+/**
+ * @brief Draws Zipf(1) ranks by binary search of the cumulative weights.
+ */
+std::vector<uint32_t> zipfianValues(size_t count, std::mt19937& gen) {
+  constexpr size_t kRanks = 1 << 20;
+  std::vector<double> cdf(kRanks);
+  double sum = 0;
+  for (size_t rank = 0; rank < kRanks; rank++) {
+    sum += 1.0 / (rank + 1);
+    cdf[rank] = sum;
+  }
+  std::uniform_real_distribution<double> dist(0, sum);
+  std::vector<uint32_t> values(count);
+  for (auto& value : values) {
+    value = std::lower_bound(cdf.begin(), cdf.end(), dist(gen)) - cdf.begin();
+  }
+  return values;
+}
+
+std::vector<uint32_t> generate(Distribution distribution, size_t count) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(count);
+  switch (distribution) {
+    case kOneByte:
+      for (auto& value : values) {
+        value = gen() & 0x7F;
+      }
+      break;
+    case kFiveByte:
+      for (auto& value : values) {
+        value = gen() | (1u << 28);
+      }
+      break;
+    case kUniform:
+      for (auto& value : values) {
+        const int bits = 7 * (gen() % 5 + 1);
+        value = bits >= 32 ? gen() | (1u << 28)
+                           : gen() >> (32 - bits) | (1u << (bits - 7));
+      }
+      break;
+    case kZipfian:
+      values = zipfianValues(count, gen);
+      break;
+    case kSortedDeltas:
+      for (auto& value : values) {
+        value = gen();
+      }
+      std::sort(values.begin(), values.end());
+      std::adjacent_difference(values.begin(), values.end(), values.begin());
+      break;
+  }
+  return values;
+}
+
+/**
+ * @brief The values of a benchmark, generated once per argument pair.
+ */
+const std::vector<uint32_t>& dataset(benchmark::State& state) {
+  static std::map<std::pair<int64_t, int64_t>, std::vector<uint32_t>> cache;
+  const auto key = std::make_pair(state.range(0), state.range(1));
+  auto it = cache.find(key);
+  if (it == cache.end()) {
+    it = cache
+             .emplace(key, generate(static_cast<Distribution>(key.first),
+                                    key.second))
+             .first;
+  }
+  state.SetLabel(kDistributionNames[key.first]);
+  return it->second;
+}
+
+/**
+ * @brief The values encoded with vlqEncodeArray(), trimmed to size.
+ */
+std::vector<uint8_t> encoded(const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  buffer.resize(vlqEncodeArray(values.data(), values.size(), buffer.data()));
+  return buffer;
+}
+
+void setCounters(benchmark::State& state, size_t count, size_t bytes) {
+  state.SetItemsProcessed(state.iterations() * count);
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+void BM_VlqEncode(benchmark::State& state) {
+  const auto& values = dataset(state);
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size = 0;
+  for (auto _ : state) {
+    size = 0;
+    for (uint32_t value : values) {
+      size += vlqEncode(value, buffer.data() + size);
+    }
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), size);
+}
+
+void BM_VlqDecode(benchmark::State& state) {
+  const auto& values = dataset(state);
+  const auto buffer = encoded(values);
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    const uint8_t* in = buffer.data();
+    for (auto& value : decoded) {
+      in += vlqDecode(in, &value);
+    }
+    benchmark::DoNotOptimize(decoded.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+void BM_VlqEncodeArray(benchmark::State& state) {
+  const auto& values = dataset(state);
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size = 0;
+  for (auto _ : state) {
+    size = vlqEncodeArray(values.data(), values.size(), buffer.data());
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), size);
+}
+
+void BM_VlqEncodeAppend(benchmark::State& state) {
+  const auto& values = dataset(state);
+  size_t size = 0;
+  for (auto _ : state) {
+    std::vector<uint8_t> buffer;
+    size = vlqEncodeArray(values.data(), values.size(), buffer);
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), size);
+}
+
+void BM_VlqDecodeArray(benchmark::State& state) {
+  const auto& values = dataset(state);
+  const auto buffer = encoded(values);
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    vlqDecodeArray(buffer.data(), decoded.size(), decoded.data());
+    benchmark::DoNotOptimize(decoded.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+void BM_Leb128EncodeArray(benchmark::State& state) {
+  const auto& values = dataset(state);
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size = 0;
+  for (auto _ : state) {
+    size = leb128EncodeArray(values.data(), values.size(), buffer.data());
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), size);
+}
+
+void BM_Leb128DecodeArray(benchmark::State& state) {
+  const auto& values = dataset(state);
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  buffer.resize(
+      leb128EncodeArray(values.data(), values.size(), buffer.data()));
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    leb128DecodeArray(buffer.data(), decoded.size(), decoded.data());
+    benchmark::DoNotOptimize(decoded.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+void BM_VlqCountValues(benchmark::State& state) {
+  const auto& values = dataset(state);
+  const auto buffer = encoded(values);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vlqCountValues(buffer.data(), buffer.size()));
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+void BM_VlqEncodeFrame(benchmark::State& state) {
+  const auto& values = dataset(state);
+  std::vector<uint8_t> buffer(vlqFrameMaxSize(values.size()));
+  size_t size = 0;
+  for (auto _ : state) {
+    size = vlqEncodeFrame(values.data(), values.size(), buffer.data());
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), size);
+}
+
+void BM_VlqDecodeFrame(benchmark::State& state) {
+  const auto& values = dataset(state);
+  std::vector<uint8_t> buffer(vlqFrameMaxSize(values.size()));
+  buffer.resize(vlqEncodeFrame(values.data(), values.size(), buffer.data()));
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vlqDecodeFrame(buffer, decoded));
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+void BM_VlqDecodeThenSum(benchmark::State& state) {
+  const auto& values = dataset(state);
+  const auto buffer = encoded(values);
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    vlqDecodeArray(buffer.data(), decoded.size(), decoded.data());
+    benchmark::DoNotOptimize(
+        std::accumulate(decoded.begin(), decoded.end(), uint64_t{0}));
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+void BM_VlqSumArray(benchmark::State& state) {
+  const auto& values = dataset(state);
+  const auto buffer = encoded(values);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(vlqSumArray(buffer.data(), values.size()));
+  }
+  setCounters(state, values.size(), buffer.size());
+}
+
+/**
+ * @brief Every distribution, 1K to 16M values.
+ */
+void codecArgs(benchmark::internal::Benchmark* bench) {
+  bench->ArgNames({"dist", "values"});
+  bench->ArgsProduct(
+      {benchmark::CreateDenseRange(kOneByte, kSortedDeltas, 1),
+       benchmark::CreateRange(1 << 10, 1 << 24, 8)});
+}
+
+}  // namespace
+
+BENCHMARK(BM_VlqEncode)->Apply(codecArgs);
+BENCHMARK(BM_VlqDecode)->Apply(codecArgs);
+BENCHMARK(BM_VlqEncodeArray)->Apply(codecArgs);
+BENCHMARK(BM_VlqEncodeAppend)->Apply(codecArgs);
+BENCHMARK(BM_VlqDecodeArray)->Apply(codecArgs);
+BENCHMARK(BM_Leb128EncodeArray)->Apply(codecArgs);
+BENCHMARK(BM_Leb128DecodeArray)->Apply(codecArgs);
+BENCHMARK(BM_VlqCountValues)->Apply(codecArgs);
+BENCHMARK(BM_VlqEncodeFrame)->Apply(codecArgs);
+BENCHMARK(BM_VlqDecodeFrame)->Apply(codecArgs);
+BENCHMARK(BM_VlqDecodeThenSum)->Apply(codecArgs);
+BENCHMARK(BM_VlqSumArray)->Apply(codecArgs);
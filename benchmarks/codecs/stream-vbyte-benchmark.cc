@@ -0,0 +1,120 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file stream-vbyte-benchmark.cc
+ * @brief Block formats compared: encoded size and throughput.
+ *
+ * Run with:
+ *   bazel run -c opt //benchmarks/codecs:stream-vbyte-benchmark
+ */
+
+// standard includes
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <benchmark/benchmark.h>
+
+// project includes
+#include "block-codec.h"
+
+namespace {
+
+constexpr size_t kNumValues = 1 << 16;
+
+/**
+ * @brief Values of a random bit width up to maxBits.
+ */
+std::vector<uint32_t> randomValues(int maxBits) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(kNumValues);
+  for (auto& value : values) {
+    int width = gen() % (maxBits + 1);
+    value = width == 0 ? 0 : gen() >> (32 - width);
+  }
+  return values;
+}
+
+/**
+ * @brief Large values drawn from a set of the given size.
+ */
+std::vector<uint32_t> lowCardinalityValues(size_t distinct) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> set(distinct);
+  for (auto& value : set) {
+    value = gen() | (1u << 28);
+  }
+  std::vector<uint32_t> values(kNumValues);
+  for (auto& value : values) {
+    value = set[gen() % distinct];
+  }
+  return values;
+}
+
+void BM_DecodeBlock(benchmark::State& state, BlockFormat format) {
+  auto values = randomValues(state.range(0));
+  std::vector<uint8_t> buffer(blockMaxEncodedSize(values.size()));
+  size_t size =
+      encodeBlock(format, values.data(), values.size(), buffer.data());
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    decodeBlock(buffer.data(), values.size(), decoded.data());
+    benchmark::DoNotOptimize(decoded.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["bytes_per_value"] =
+      static_cast<double>(size) / values.size();
+}
+
+void BM_EncodeBlock(benchmark::State& state, BlockFormat format) {
+  auto values = randomValues(state.range(0));
+  std::vector<uint8_t> buffer(blockMaxEncodedSize(values.size()));
+  for (auto _ : state) {
+    encodeBlock(format, values.data(), values.size(), buffer.data());
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+void BM_DecodeLowCardinality(benchmark::State& state, BlockFormat format) {
+  auto values = lowCardinalityValues(state.range(0));
+  std::vector<uint8_t> buffer(blockMaxEncodedSize(values.size()));
+  size_t size =
+      encodeBlock(format, values.data(), values.size(), buffer.data());
+  std::vector<uint32_t> decoded(values.size());
+  for (auto _ : state) {
+    decodeBlock(buffer.data(), values.size(), decoded.data());
+    benchmark::DoNotOptimize(decoded.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["bytes_per_value"] =
+      static_cast<double>(size) / values.size();
+}
+
+}  // namespace
+
+// Argument: maximum bit width of the values.
+BENCHMARK_CAPTURE(BM_DecodeBlock, Vlq, BlockFormat::kVlq)->Arg(12)->Arg(32);
+BENCHMARK_CAPTURE(BM_DecodeBlock, StreamVByte, BlockFormat::kStreamVByte)
+    ->Arg(12)
+    ->Arg(32);
+BENCHMARK_CAPTURE(BM_EncodeBlock, Vlq, BlockFormat::kVlq)->Arg(12)->Arg(32);
+BENCHMARK_CAPTURE(BM_EncodeBlock, StreamVByte, BlockFormat::kStreamVByte)
+    ->Arg(12)
+    ->Arg(32);
+BENCHMARK_CAPTURE(BM_DecodeBlock, Pfor, BlockFormat::kPfor)->Arg(12)->Arg(32);
+BENCHMARK_CAPTURE(BM_EncodeBlock, Pfor, BlockFormat::kPfor)->Arg(12)->Arg(32);
+
+// Argument: number of distinct values.
+BENCHMARK_CAPTURE(BM_DecodeLowCardinality, Vlq, BlockFormat::kVlq)->Arg(300);
+BENCHMARK_CAPTURE(BM_DecodeLowCardinality, Dictionary,
+                  BlockFormat::kDictionary)
+    ->Arg(300);
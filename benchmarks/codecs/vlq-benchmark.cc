@@ -0,0 +1,168 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-benchmark.cc
+ * @brief Throughput benchmarks for the VLQ codec.
+ *
+ * Run with:
+ *   bazel run -c opt //benchmarks/codecs:vlq-benchmark
+ */
+
+// standard includes
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <benchmark/benchmark.h>
+
+// project includes
+#include "vlq-parallel.h"
+#include "vlq.h"
+
+namespace {
+
+constexpr size_t kNumValues = 1 << 16;
+
+/**
+ * @brief Uniform values over the whole uint32_t range (mostly 5 bytes).
+ */
+std::vector<uint32_t> uniformValues() {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(kNumValues);
+  for (auto& value : values) {
+    value = gen();
+  }
+  return values;
+}
+
+/**
+ * @brief Exponentially distributed values (mostly 1 or 2 bytes).
+ */
+std::vector<uint32_t> skewedValues() {
+  std::mt19937 gen(42);
+  std::exponential_distribution<double> dist(1.0 / 1000);
+  std::vector<uint32_t> values(kNumValues);
+  for (auto& value : values) {
+    value = static_cast<uint32_t>(dist(gen));
+  }
+  return values;
+}
+
+/**
+ * @brief The original encoder, which reverses the groups through a temp
+ * buffer. Kept as baseline.
+ */
+size_t encodeReversed(uint32_t value, uint8_t* buffer) {
+  size_t size = 0;
+  uint8_t temp[5];
+
+  do {
+    temp[size] = (value & 0x7F);
+    if (size > 0) {
+      temp[size] |= 0x80;
+    }
+    value >>= 7;
+    size++;
+  } while (value > 0);
+
+  for (size_t i = 0; i < size; i++) {
+    buffer[i] = temp[size - i - 1];
+  }
+  return size;
+}
+
+template <auto ENCODE>
+void encodeLoop(benchmark::State& state, const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size = 0;
+  for (auto _ : state) {
+    size = 0;
+    for (uint32_t value : values) {
+      size += ENCODE(value, buffer.data() + size);
+    }
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+void BM_EncodeReversed_Uniform(benchmark::State& state) {
+  encodeLoop<encodeReversed>(state, uniformValues());
+}
+
+void BM_EncodeReversed_Skewed(benchmark::State& state) {
+  encodeLoop<encodeReversed>(state, skewedValues());
+}
+
+void BM_EncodeLengthFirst_Uniform(benchmark::State& state) {
+  encodeLoop<vlqEncodeValue<uint32_t>>(state, uniformValues());
+}
+
+void BM_EncodeLengthFirst_Skewed(benchmark::State& state) {
+  encodeLoop<vlqEncodeValue<uint32_t>>(state, skewedValues());
+}
+
+void encodeArray(benchmark::State& state,
+                 const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size = 0;
+  for (auto _ : state) {
+    size = vlqEncodeArray(values.data(), values.size(), buffer.data());
+    benchmark::DoNotOptimize(buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+void BM_EncodeArrayWide_Uniform(benchmark::State& state) {
+  encodeArray(state, uniformValues());
+}
+
+void BM_EncodeArrayWide_Skewed(benchmark::State& state) {
+  encodeArray(state, skewedValues());
+}
+
+/**
+ * @brief Encodes and decodes 64M uniform values on state.range(0) threads.
+ */
+void BM_ParallelRoundTrip(benchmark::State& state) {
+  const size_t numThreads = state.range(0);
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(1 << 26);
+  for (auto& value : values) {
+    value = gen();
+  }
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  std::vector<uint32_t> decoded(values.size());
+  VlqChunkTable table;
+  size_t size = 0;
+  for (auto _ : state) {
+    size = vlqEncodeArrayParallel(values.data(), values.size(), buffer.data(),
+                                  &table, numThreads);
+    vlqDecodeArrayParallel(buffer.data(), values.size(), decoded.data(), table,
+                           numThreads);
+    benchmark::DoNotOptimize(decoded.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+}  // namespace
+
+BENCHMARK(BM_EncodeReversed_Uniform);
+BENCHMARK(BM_EncodeReversed_Skewed);
+BENCHMARK(BM_EncodeLengthFirst_Uniform);
+BENCHMARK(BM_EncodeLengthFirst_Skewed);
+BENCHMARK(BM_EncodeArrayWide_Uniform);
+BENCHMARK(BM_EncodeArrayWide_Skewed);
+BENCHMARK(BM_ParallelRoundTrip)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
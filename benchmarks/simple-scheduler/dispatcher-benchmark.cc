@@ -0,0 +1,201 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file dispatcher-benchmark.cc
+ * @brief Dispatcher throughput, latency and firing jitter.
+ *
+ * BM_SpawnReady*: every iteration schedules state.range(0) tasks that are
+ * all due, hands them to the executor (worker pool or thread per task) and
+ * waits for the last one. latency_us is the mean time from the hand-off to
+ * the start of a task.
+ *
+ * BM_FiringJitter: a launched dispatcher runs one task 1 to 2 ms ahead at a
+ * time. jitter_us is the mean delay from the deadline to the start of the
+ * task, max_jitter_us the worst one.
+ *
+ * BM_WakeupLatency: an idle launched dispatcher, asleep with only a far
+ * deadline pending, is given a task that is already due. wakeup_us is the
+ * mean delay from scheduleFunction() to the start of the task.
+ *
+ * Run with:
+ *   bazel run -c opt //benchmarks/simple-scheduler:dispatcher-benchmark
+ */
+
+// standard includes
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+
+// third-party includes
+#include <benchmark/benchmark.h>
+
+// project includes
+#include "dispatcher.h"
+#include "scheduler.h"
+#include "timing-wheel.h"
+
+namespace {
+
+using scheduler::Clock;
+using scheduler::Dispatcher;
+using scheduler::Scheduler;
+using scheduler::TimePoint;
+using scheduler::TimingWheelScheduler;
+using std::chrono::steady_clock;
+
+constexpr TimePoint kDue{};
+
+/**
+ * @brief Counts the tasks run and sums their fire-to-execute latency.
+ */
+struct Probe {
+  std::atomic<size_t> done{0};
+  std::atomic<int64_t> latencyNs{0};
+  steady_clock::time_point start;
+
+  void schedule(Scheduler& tasks, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      tasks.scheduleFunction(
+          [this]() {
+            latencyNs += (steady_clock::now() - start).count();
+            done++;
+          },
+          kDue);
+    }
+  }
+
+  void waitFor(size_t count) const {
+    while (done.load() < count) {
+      std::this_thread::yield();
+    }
+  }
+
+  void report(benchmark::State& state, size_t count) const {
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["latency_us"] = static_cast<double>(latencyNs.load()) /
+                                   (state.iterations() * count) / 1000.0;
+  }
+};
+
+/**
+ * @brief The dispatcher, running ready tasks on its worker pool.
+ */
+void BM_SpawnReadyPool(benchmark::State& state) {
+  const size_t count = state.range(0);
+  auto tasks = std::make_shared<Scheduler>();
+  Dispatcher<Scheduler> dispatcher;
+  Probe probe;
+  for (auto _ : state) {
+    state.PauseTiming();
+    probe.schedule(*tasks, count);
+    probe.done = 0;
+    state.ResumeTiming();
+    probe.start = steady_clock::now();
+    dispatcher.spawnReady(kDue, tasks);
+    probe.waitFor(count);
+  }
+  probe.report(state, count);
+}
+BENCHMARK(BM_SpawnReadyPool)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->UseRealTime();
+
+/**
+ * @brief Baseline: one detached thread per ready task.
+ */
+void BM_SpawnReadyDetached(benchmark::State& state) {
+  const size_t count = state.range(0);
+  auto tasks = std::make_shared<Scheduler>();
+  Probe probe;
+  for (auto _ : state) {
+    state.PauseTiming();
+    probe.schedule(*tasks, count);
+    probe.done = 0;
+    state.ResumeTiming();
+    probe.start = steady_clock::now();
+    for (auto& func : tasks->popReady(kDue)) {
+      std::thread(std::move(func)).detach();
+    }
+    probe.waitFor(count);
+  }
+  probe.report(state, count);
+}
+BENCHMARK(BM_SpawnReadyDetached)
+    ->RangeMultiplier(4)
+    ->Range(64, 16384)
+    ->UseRealTime();
+
+template <typename SCHEDULER>
+void BM_FiringJitter(benchmark::State& state) {
+  using std::chrono::duration;
+  using std::chrono::microseconds;
+  auto tasks = std::make_shared<SCHEDULER>();
+  Dispatcher<SCHEDULER> dispatcher(1);
+  dispatcher.launch(tasks);
+  std::mt19937 gen(42);
+  double total = 0;
+  double worst = 0;
+  for (auto _ : state) {
+    std::atomic<bool> fired{false};
+    TimePoint firedAt;
+    const TimePoint deadline = Clock::now() + microseconds(1000 + gen() % 1000);
+    tasks->scheduleFunction(
+        [&]() {
+          firedAt = Clock::now();
+          fired = true;
+        },
+        deadline);
+    while (!fired.load()) {
+      std::this_thread::yield();
+    }
+    const double jitter =
+        duration<double, std::micro>(firedAt - deadline).count();
+    total += jitter;
+    worst = std::max(worst, jitter);
+  }
+  dispatcher.stop();
+  state.counters["jitter_us"] = total / state.iterations();
+  state.counters["max_jitter_us"] = worst;
+}
+BENCHMARK(BM_FiringJitter<Scheduler>)->Iterations(500)->UseRealTime();
+BENCHMARK(BM_FiringJitter<TimingWheelScheduler>)
+    ->Iterations(500)
+    ->UseRealTime();
+
+template <typename SCHEDULER>
+void BM_WakeupLatency(benchmark::State& state) {
+  using std::chrono::duration;
+  using std::chrono::hours;
+  auto tasks = std::make_shared<SCHEDULER>();
+  Dispatcher<SCHEDULER> dispatcher(1);
+  dispatcher.launch(tasks);
+  tasks->scheduleFunction([]() {}, Clock::now() + hours(1));
+  double total = 0;
+  for (auto _ : state) {
+    std::atomic<bool> fired{false};
+    TimePoint firedAt;
+    const TimePoint scheduledAt = Clock::now();
+    tasks->scheduleFunction(
+        [&]() {
+          firedAt = Clock::now();
+          fired = true;
+        },
+        scheduledAt);
+    while (!fired.load()) {
+      std::this_thread::yield();
+    }
+    total += duration<double, std::micro>(firedAt - scheduledAt).count();
+  }
+  dispatcher.stop();
+  state.counters["wakeup_us"] = total / state.iterations();
+}
+BENCHMARK(BM_WakeupLatency<Scheduler>)->UseRealTime();
+BENCHMARK(BM_WakeupLatency<TimingWheelScheduler>)->UseRealTime();
+
+}  // namespace
@@ -0,0 +1,88 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file scheduler-benchmark.cc
+ * @brief Scheduler backends compared: binary heap vs timing wheel.
+ *
+ * With state.range(0) tasks pending, every iteration advances the time by
+ * one microsecond, pops the tasks that became ready and schedules one more,
+ * so the number of pending tasks stays about the same.
+ *
+ * BM_ScheduleAndCancel is the request timeout case: every iteration
+ * schedules a timeout as far ahead as the pending ones and cancels it.
+ *
+ * Run with:
+ *   bazel run -c opt //benchmarks/simple-scheduler:scheduler-benchmark
+ */
+
+// standard includes
+#include <random>
+
+// third-party includes
+#include <benchmark/benchmark.h>
+
+// project includes
+#include "scheduler.h"
+#include "timing-wheel.h"
+
+namespace {
+
+using scheduler::TimePoint;
+using std::chrono::microseconds;
+
+template <typename SCHEDULER>
+void BM_ScheduleAndPop(benchmark::State& state) {
+  const auto pending = static_cast<uint64_t>(state.range(0));
+  std::mt19937_64 gen(42);
+  SCHEDULER tasks;
+  for (uint64_t i = 0; i < pending; i++) {
+    tasks.scheduleFunction([]() {},
+                           TimePoint{} + microseconds(1 + gen() % pending));
+  }
+  TimePoint now{};
+  size_t popped = 0;
+  for (auto _ : state) {
+    now += microseconds(1);
+    popped += tasks.popReady(now).size();
+    tasks.scheduleFunction([]() {}, now + microseconds(1 + gen() % pending));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["popped"] = static_cast<double>(popped) / state.iterations();
+}
+BENCHMARK(BM_ScheduleAndPop<scheduler::Scheduler>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_ScheduleAndPop<scheduler::TimingWheelScheduler>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22);
+
+template <typename SCHEDULER>
+void BM_ScheduleAndCancel(benchmark::State& state) {
+  const auto pending = static_cast<uint64_t>(state.range(0));
+  std::mt19937_64 gen(42);
+  SCHEDULER tasks;
+  for (uint64_t i = 0; i < pending; i++) {
+    tasks.scheduleFunction([]() {},
+                           TimePoint{} + microseconds(1 + gen() % pending));
+  }
+  TimePoint now{};
+  for (auto _ : state) {
+    now += microseconds(1);
+    tasks.popReady(now);
+    const auto handle =
+        tasks.scheduleFunction([]() {}, now + microseconds(pending));
+    benchmark::DoNotOptimize(tasks.cancel(handle));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScheduleAndCancel<scheduler::Scheduler>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_ScheduleAndCancel<scheduler::TimingWheelScheduler>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22);
+
+}  // namespace
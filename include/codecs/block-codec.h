@@ -0,0 +1,70 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file block-codec.h
+ * @brief Blocks of integers encoded with a format chosen per block.
+ *
+ * A block starts with a one-byte format tag followed by the data encoded with
+ * that format:
+ *
+ *     [format][encoded values ...]
+ *
+ * The block has the same array-level API shape as vlqEncodeArray() and
+ * vlqDecodeArray(), so the caller can pick, for each block, the format that
+ * suits its data: VLQ for the smallest size on skewed values, Stream VByte for
+ * the fastest decoding, PFOR for dense values in a narrow range, dictionary
+ * for few distinct values.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @brief Formats a block can be encoded with.
+ */
+enum class BlockFormat : uint8_t {
+  kVlq = 0,          ///< @see vlq.h
+  kStreamVByte = 1,  ///< @see stream-vbyte.h
+  kPfor = 2,         ///< @see pfor.h
+  kDictionary = 3,   ///< @see dictionary.h
+};
+
+/**
+ * @brief Upper bound of the encoded size of a block of count integers.
+ *
+ * @param count The number of integers in the block.
+ * @return The number of bytes needed in the worst case, for any format.
+ */
+size_t blockMaxEncodedSize(size_t count);
+
+/**
+ * @brief Encodes an array of integers as a block of the given format.
+ *
+ * @param format The format to encode the values with.
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the block.
+ * @return The total number of bytes of the block, including its tag.
+ */
+size_t encodeBlock(BlockFormat format, const uint32_t* values, size_t count,
+                   uint8_t* buffer);
+
+/**
+ * @brief Decodes a block, whatever format it was encoded with.
+ *
+ * @param buffer The input buffer containing the block.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes of the block, including its tag, or 0 if
+ * the format tag is unknown or a PFOR block header is corrupt.
+ */
+size_t decodeBlock(const uint8_t* buffer, size_t count, uint32_t* values);
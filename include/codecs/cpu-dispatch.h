@@ -0,0 +1,141 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file cpu-dispatch.h
+ * @brief Runtime selection of the SIMD kernels of the codecs.
+ *
+ * The CPU is checked once, on first use, and every kernel is bound to the
+ * best implementation of the active tier through a function pointer, so a
+ * single binary runs the best code on every host. A call costs one indirect
+ * call, with no feature test.
+ *
+ * The active tier can be lowered, to test or benchmark every implementation
+ * on the same host:
+ *  - with cpuForceTier(), at any time,
+ *  - with the CODECS_CPU_TIER environment variable (scalar, sse4.1, avx2 or
+ *    avx512), read once at start.
+ */
+#pragma once
+
+// standard includes
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @brief Instruction set levels of the codec kernels, in increasing order.
+ */
+enum class CpuTier {
+  kScalar,  ///< Portable C++.
+  kSse41,   ///< SSE4.1 (pshufb, pmovzx, ...).
+  kAvx2,    ///< AVX2 and POPCNT.
+  kAvx512,  ///< AVX-512 F, BW and VL.
+};
+
+/**
+ * @brief Number of CpuTier values.
+ */
+inline constexpr size_t kCpuTiers = 4;
+
+/**
+ * @brief Returns the highest tier the CPU supports.
+ */
+CpuTier cpuDetectedTier();
+
+/**
+ * @brief Returns the tier the kernels are bound to.
+ */
+CpuTier cpuTier();
+
+/**
+ * @brief Binds every kernel to the given tier.
+ *
+ * Kernels without an implementation for that tier use the next lower one.
+ * It must not run concurrently with the kernels it rebinds.
+ *
+ * @param tier The tier to use, cpuDetectedTier() to undo a forced one.
+ * @return false, and nothing changes, if the CPU does not support the tier.
+ */
+bool cpuForceTier(CpuTier tier);
+
+/**
+ * @brief Returns the name of a tier, as taken by CODECS_CPU_TIER.
+ */
+const char* cpuTierName(CpuTier tier);
+
+/**
+ * @brief A kernel registered for rebinding by cpuForceTier().
+ */
+class CpuKernelBase {
+ public:
+  CpuKernelBase(const CpuKernelBase&) = delete;
+  CpuKernelBase& operator=(const CpuKernelBase&) = delete;
+
+  /**
+   * @brief Points the kernel to its implementation for the tier.
+   */
+  virtual void bind(CpuTier tier) = 0;
+
+ protected:
+  CpuKernelBase() = default;
+  ~CpuKernelBase();
+
+  /**
+   * @brief Binds the kernel to the active tier and registers it.
+   */
+  void attach();
+};
+
+/**
+ * @class CpuKernel
+ * @brief Function pointer bound to the best implementation of a kernel.
+ *
+ * Each tier has an entry, nullptr where the kernel has no implementation of
+ * its own; the scalar one is required. Declare it as a function-local static,
+ * so it is bound on first use:
+ *
+ * @code
+ * size_t countValues(const uint8_t* buffer, size_t size) {
+ *   static CpuKernel<size_t (*)(const uint8_t*, size_t)> kernel(
+ *       {countScalar, countSse41, countAvx2, nullptr});
+ *   return kernel(buffer, size);
+ * }
+ * @endcode
+ */
+template <typename FN>
+class CpuKernel final : public CpuKernelBase {
+ public:
+  explicit CpuKernel(const std::array<FN, kCpuTiers>& implementations)
+      : _implementations(implementations) {
+    attach();
+  }
+
+  void bind(CpuTier tier) override {
+    size_t i = static_cast<size_t>(tier);
+    while (i > 0 && _implementations[i] == nullptr) {
+      i--;
+    }
+    _active.store(_implementations[i], std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Calls the bound implementation.
+   */
+  template <typename... ARGS>
+  decltype(auto) operator()(ARGS&&... args) const {
+    return _active.load(std::memory_order_relaxed)(
+        std::forward<ARGS>(args)...);
+  }
+
+ private:
+  std::array<FN, kCpuTiers> _implementations;  ///< Indexed by CpuTier.
+  std::atomic<FN> _active{nullptr};            ///< Bound implementation.
+};
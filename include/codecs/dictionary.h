@@ -0,0 +1,75 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file dictionary.h
+ * @brief Dictionary encoding of low-cardinality 32-bit integers.
+ *
+ * Values are encoded in blocks of kDictionaryBlockSize. A block lists its
+ * distinct values once, in order of first appearance, and replaces every
+ * value by its index in that list:
+ *
+ *     [entries: VLQ][entry values: VLQ each][indexes: PFOR]
+ *
+ * A column of a few hundred large distinct values then costs about one byte
+ * per value instead of 3 to 5. The dictionary is built in one pass with a
+ * hash table, the indexes are bit-packed by pforEncodeArray(), and decoding
+ * resolves them with AVX2 gathers when the CPU has them.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+
+// third-party includes
+
+// project includes
+#include "pfor.h"
+#include "vlq.h"
+
+/**
+ * @brief Number of values of a dictionary block, the last one may have
+ * fewer.
+ */
+inline constexpr size_t kDictionaryBlockSize = 4096;
+
+/**
+ * @brief Upper bound of the encoded size of count integers.
+ *
+ * @param count The number of integers to encode.
+ * @return The number of bytes needed in the worst case (all values distinct).
+ */
+constexpr size_t dictionaryMaxEncodedSize(size_t count) {
+  const auto blockBytes = [](size_t values) {
+    return kVlqMaxBytes<uint32_t> + values * kVlqMaxBytes<uint32_t> +
+           pforMaxEncodedSize(values);
+  };
+  const size_t rest = count % kDictionaryBlockSize;
+  return count / kDictionaryBlockSize * blockBytes(kDictionaryBlockSize) +
+         (rest == 0 ? 0 : blockBytes(rest));
+}
+
+/**
+ * @brief Encodes an array of integers into dictionary format.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @return The total number of bytes used in encoding.
+ */
+size_t dictionaryEncodeArray(const uint32_t* values, size_t count,
+                             uint8_t* buffer);
+
+/**
+ * @brief Decodes a dictionary byte array into an array of integers.
+ *
+ * @param buffer The input buffer containing dictionary data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+size_t dictionaryDecodeArray(const uint8_t* buffer, size_t count,
+                             uint32_t* values);
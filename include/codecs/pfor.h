@@ -0,0 +1,87 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file pfor.h
+ * @brief Patched frame-of-reference (PFOR) encoding of 32-bit integers.
+ *
+ * Values are encoded in blocks of 128. A block stores its minimum as a
+ * reference and packs every value minus the reference on a fixed number of
+ * bits. The few values that need more bits (exceptions) keep their low bits
+ * in the packed data and have their high bits patched in afterwards:
+ *
+ *     [reference: 4][bits: 1][exceptions: 1][packed: 16 * bits]
+ *     [position of each exception: 1 each][high bits of each exception: VLQ]
+ *
+ * The bit width is the one that gives the smallest block. The packed data is
+ * laid out for 128-bit SIMD: value i goes to 32-bit lane i % 4, so four
+ * values are unpacked with every shift and mask. The values that don't fill
+ * a last block are encoded as plain VLQ.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @brief Number of values of a PFOR block.
+ */
+inline constexpr size_t kPforBlockSize = 128;
+
+/**
+ * @brief Upper bound of the encoded size of count integers.
+ *
+ * @param count The number of integers to encode.
+ * @return The number of bytes needed in the worst case.
+ */
+constexpr size_t pforMaxEncodedSize(size_t count) {
+  constexpr size_t kMaxBlockBytes = 6 + kPforBlockSize * sizeof(uint32_t);
+  return count / kPforBlockSize * kMaxBlockBytes +
+         count % kPforBlockSize * 5;  // Plain VLQ.
+}
+
+/**
+ * @brief Encodes an array of integers into PFOR format.
+ *
+ * Uses SSE2 where the target has it (every x86-64 CPU).
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @return The total number of bytes used in encoding.
+ */
+size_t pforEncodeArray(const uint32_t* values, size_t count, uint8_t* buffer);
+
+/**
+ * @brief Decodes a PFOR byte array into an array of integers.
+ *
+ * Uses SSE2 where the target has it (every x86-64 CPU).
+ *
+ * @param buffer The input buffer containing PFOR data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding, or 0 if a block
+ * header is corrupt (bit width over 32 or exception outside the block).
+ */
+size_t pforDecodeArray(const uint8_t* buffer, size_t count, uint32_t* values);
+
+/**
+ * @brief Encodes an array of integers into PFOR format, one value at a time.
+ * @see pforEncodeArray()
+ */
+size_t pforEncodeArrayScalar(const uint32_t* values, size_t count,
+                             uint8_t* buffer);
+
+/**
+ * @brief Decodes a PFOR byte array one value at a time.
+ * @see pforDecodeArray()
+ */
+size_t pforDecodeArrayScalar(const uint8_t* buffer, size_t count,
+                             uint32_t* values);
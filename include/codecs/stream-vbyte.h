@@ -0,0 +1,81 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file stream-vbyte.h
+ * @brief Stream VByte encoding and decoding of 32-bit integers.
+ *
+ * Unlike VLQ, the length of each value is not spread over its bytes. Lengths
+ * are kept as 2-bit codes in a separate stream of control bytes, one control
+ * byte per group of 4 values, followed by the data bytes (1 to 4 per value,
+ * little-endian):
+ *
+ *     [ctrl 0][ctrl 1]...[ctrl n/4] [data of v0][data of v1]...
+ *
+ *     ctrl = len(v0)-1 | (len(v1)-1) << 2 | (len(v2)-1) << 4 | (len(v3)-1) << 6
+ *
+ * A decoder knows where every value of a group starts just from its control
+ * byte, so a group of 4 values is decoded with a single shuffle.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @brief Upper bound of the encoded size of count integers.
+ *
+ * @param count The number of integers to encode.
+ * @return The number of bytes needed in the worst case.
+ */
+constexpr size_t streamVByteMaxEncodedSize(size_t count) {
+  return (count + 3) / 4 + count * sizeof(uint32_t);
+}
+
+/**
+ * @brief Encodes an array of integers into Stream VByte format.
+ *
+ * Uses SSE4.1 when the CPU supports it.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @return The total number of bytes used in encoding.
+ */
+size_t streamVByteEncodeArray(const uint32_t* values, size_t count,
+                              uint8_t* buffer);
+
+/**
+ * @brief Decodes a Stream VByte byte array into an array of integers.
+ *
+ * Uses SSE4.1 when the CPU supports it.
+ *
+ * @param buffer The input buffer containing Stream VByte data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+size_t streamVByteDecodeArray(const uint8_t* buffer, size_t count,
+                              uint32_t* values);
+
+/**
+ * @brief Encodes an array of integers into Stream VByte format, one value at
+ * a time.
+ * @see streamVByteEncodeArray()
+ */
+size_t streamVByteEncodeArrayScalar(const uint32_t* values, size_t count,
+                                    uint8_t* buffer);
+
+/**
+ * @brief Decodes a Stream VByte byte array one value at a time.
+ * @see streamVByteDecodeArray()
+ */
+size_t streamVByteDecodeArrayScalar(const uint8_t* buffer, size_t count,
+                                    uint32_t* values);
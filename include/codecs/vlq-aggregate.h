@@ -0,0 +1,129 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-aggregate.h
+ * @brief Aggregates computed straight from VLQ-encoded arrays.
+ *
+ * A sum, a minimum/maximum or a count usually does not need the decoded
+ * array, only a pass over its values. These kernels run the SIMD decoder and
+ * fold every step into accumulators while the values are still in registers,
+ * so there is no temporary array and no second pass over memory.
+ *
+ * The visitor functions handle any other computation: values are decoded
+ * into a small tile that stays in L1 and handed to the visitor one by one.
+ */
+#pragma once
+
+// standard includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// third-party includes
+
+// project includes
+#include "vlq.h"
+
+/**
+ * @brief Result of vlqSumArray().
+ */
+struct VlqSumResult {
+  uint64_t sum;     ///< Sum of the values, which cannot overflow.
+  size_t consumed;  ///< Bytes of the encoded values.
+};
+
+/**
+ * @brief Result of vlqMinMaxArray().
+ */
+struct VlqMinMaxResult {
+  uint32_t min;     ///< Smallest value, UINT32_MAX for no values.
+  uint32_t max;     ///< Largest value, 0 for no values.
+  size_t consumed;  ///< Bytes of the encoded values.
+};
+
+/**
+ * @brief Result of the counting functions.
+ */
+struct VlqCountResult {
+  size_t count;     ///< Values that match.
+  size_t consumed;  ///< Bytes of the encoded values.
+};
+
+/**
+ * @brief Sums VLQ-encoded values without decoding them to memory.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The number of encoded integers.
+ * @return The sum and the number of bytes consumed.
+ */
+VlqSumResult vlqSumArray(const uint8_t* buffer, size_t count);
+
+/**
+ * @brief Finds the smallest and largest VLQ-encoded values without decoding
+ * them to memory.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The number of encoded integers.
+ * @return The minimum, the maximum and the number of bytes consumed.
+ */
+VlqMinMaxResult vlqMinMaxArray(const uint8_t* buffer, size_t count);
+
+/**
+ * @brief Counts the VLQ-encoded values in [low, high] without decoding them
+ * to memory.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The number of encoded integers.
+ * @param low The smallest value counted.
+ * @param high The largest value counted, not less than low.
+ * @return The number of values in range and of bytes consumed.
+ */
+VlqCountResult vlqCountInRangeArray(const uint8_t* buffer, size_t count,
+                                    uint32_t low, uint32_t high);
+
+/**
+ * @brief Values decoded at a time for the visitor: 1 KiB, well within L1.
+ */
+inline constexpr size_t kVlqVisitTile = 256;
+
+/**
+ * @brief Decodes VLQ-encoded values and calls a visitor with each of them.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The number of encoded integers.
+ * @param visit Called as visit(uint32_t) for every value, in order.
+ * @return The total number of bytes consumed in decoding.
+ */
+template <typename VISITOR>
+size_t vlqVisitArray(const uint8_t* buffer, size_t count, VISITOR&& visit) {
+  uint32_t tile[kVlqVisitTile];
+  size_t consumed = 0;
+  for (size_t first = 0; first < count; first += kVlqVisitTile) {
+    const size_t tileCount = std::min(kVlqVisitTile, count - first);
+    consumed += vlqDecodeArray(buffer + consumed, tileCount, tile);
+    for (size_t i = 0; i < tileCount; i++) {
+      visit(tile[i]);
+    }
+  }
+  return consumed;
+}
+
+/**
+ * @brief Counts the VLQ-encoded values that satisfy a predicate.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The number of encoded integers.
+ * @param predicate Called as predicate(uint32_t) for every value.
+ * @return The number of values that match and of bytes consumed.
+ */
+template <typename PREDICATE>
+VlqCountResult vlqCountIfArray(const uint8_t* buffer, size_t count,
+                               PREDICATE&& predicate) {
+  size_t matches = 0;
+  const size_t consumed = vlqVisitArray(
+      buffer, count, [&](uint32_t value) { matches += predicate(value); });
+  return {matches, consumed};
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-block-array.h
+ * @brief VLQ-encoded array with random access through a block index.
+ *
+ * The values are encoded as a single VLQ stream, exactly as vlqEncodeArray()
+ * writes it, and split into blocks of a fixed number of values. A skip index
+ * keeps the byte offset where each block starts and, optionally, the first
+ * value of each block:
+ *
+ *     data:     [v0 v1 ... v127][v128 ... v255][v256 ...]
+ *                ^               ^              ^
+ *     offsets:   0               143            301
+ *     first:     v0              v128           v256
+ *
+ * Reading element i only decodes the block that holds it, instead of every
+ * value before it.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @class VlqBlockArray
+ * @brief Compressed array of 32-bit integers with random access.
+ */
+class VlqBlockArray {
+ public:
+  static constexpr size_t kDefaultBlockSize = 128;
+
+  /**
+   * @brief Encodes an array of integers and builds its block index.
+   *
+   * @param values The input array of integers to encode.
+   * @param count The number of integers in the array.
+   * @param blockSize The number of values per block, greater than 0.
+   * @param indexFirstValues Whether to keep the first value of each block in
+   * the index. It speeds up lowerBound() at the cost of 4 bytes per block.
+   * @throws std::length_error If the values take more than 4 GiB encoded,
+   * past what the 32-bit block offsets can address.
+   */
+  VlqBlockArray(const uint32_t* values, size_t count,
+                size_t blockSize = kDefaultBlockSize,
+                bool indexFirstValues = true);
+
+  /**
+   * @brief Number of values in the array.
+   */
+  size_t size() const { return _count; }
+
+  /**
+   * @brief Bytes used by the encoded values and the index.
+   */
+  size_t encodedSize() const;
+
+  /**
+   * @brief The encoded values, which vlqDecodeArray() can decode as a whole.
+   */
+  std::span<const uint8_t> data() const { return _data; }
+
+  /**
+   * @brief Reads a single value.
+   *
+   * @param index The position of the value, less than size().
+   * @return The value at that position.
+   */
+  uint32_t get(size_t index) const;
+
+  /**
+   * @brief Decodes consecutive values.
+   *
+   * @param first The position of the first value to decode.
+   * @param count The number of values to decode.
+   * @param values The output array to store decoded integers.
+   * @return The number of values decoded, less than count if the range goes
+   * past the end of the array.
+   */
+  size_t decodeRange(size_t first, size_t count, uint32_t* values) const;
+
+  /**
+   * @brief Finds the first value not less than the given one.
+   *
+   * The array must be sorted. The block is found with a binary search of the
+   * first values (taken from the index, or decoded from the start of each
+   * block otherwise), then only that block is decoded.
+   *
+   * @param value The value to search for.
+   * @return The position of the first value >= value, or size() if none.
+   */
+  size_t lowerBound(uint32_t value) const;
+
+ private:
+  /**
+   * @brief First value of a block.
+   */
+  uint32_t firstValue(size_t block) const;
+
+  /**
+   * @brief Pointer to the encoded value at a position.
+   */
+  const uint8_t* locate(size_t index) const;
+
+  size_t _count;
+  size_t _blockSize;
+  std::vector<uint8_t> _data;
+  std::vector<uint32_t> _offsets;      ///< Byte offset of each block.
+                                       ///< The constructor enforces 4 GiB.
+  std::vector<uint32_t> _firstValues;  ///< First value of each block.
+};
@@ -0,0 +1,96 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-delta.h
+ * @brief Delta and zigzag coding fused with VLQ encoding and decoding.
+ *
+ * Sorted sequences, e.g. posting lists, are stored as the differences between
+ * consecutive values (the first one relative to 0). These are small, so they
+ * take 1 or 2 VLQ bytes instead of 4 or 5:
+ *
+ *     values:  1000 1003 1010 1100
+ *     deltas:  1000    3    7   90
+ *
+ * Signed sequences are delta coded too, then the deltas are zigzag mapped so
+ * small negative deltas stay small: 0, -1, 1, -2, 2 ... -> 0, 1, 2, 3, 4 ...
+ *
+ * Deltas are computed while encoding and summed back while decoding, so no
+ * intermediate array is used in either direction.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @brief Maps a signed integer to an unsigned one, small magnitudes first.
+ */
+constexpr uint32_t zigzagEncode(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^
+         static_cast<uint32_t>(value >> 31);
+}
+
+/**
+ * @brief Inverse of zigzagEncode().
+ */
+constexpr int32_t zigzagDecode(uint32_t value) {
+  return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+}
+
+/**
+ * @brief Encodes a sorted array as VLQ-encoded deltas.
+ *
+ * Unsorted input still round-trips, since deltas wrap around modulo 2^32,
+ * but decreasing steps take 5 bytes.
+ *
+ * @param values The input array of non-decreasing integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @return The total number of bytes used in encoding.
+ */
+size_t vlqEncodeDeltaArray(const uint32_t* values, size_t count,
+                           uint8_t* buffer);
+
+/**
+ * @brief Decodes VLQ-encoded deltas back into the sorted array.
+ *
+ * The deltas are summed with a vectorized prefix sum right after each block
+ * of them is decoded, while it is still in the L1 cache.
+ *
+ * @param buffer The input buffer containing VLQ-encoded deltas.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+size_t vlqDecodeDeltaArray(const uint8_t* buffer, size_t count,
+                           uint32_t* values);
+
+/**
+ * @brief Encodes a signed array as VLQ-encoded zigzag deltas.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @return The total number of bytes used in encoding.
+ */
+size_t vlqEncodeZigzagDeltaArray(const int32_t* values, size_t count,
+                                 uint8_t* buffer);
+
+/**
+ * @brief Decodes VLQ-encoded zigzag deltas back into the signed array.
+ *
+ * @param buffer The input buffer containing VLQ-encoded zigzag deltas.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+size_t vlqDecodeZigzagDeltaArray(const uint8_t* buffer, size_t count,
+                                 int32_t* values);
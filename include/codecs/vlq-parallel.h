@@ -0,0 +1,81 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-parallel.h
+ * @brief Multi-threaded VLQ encoding and decoding of large arrays.
+ *
+ * The array is split into chunks of a fixed number of values, which the
+ * threads take one at a time. Encoding is a parallel prefix sum in three
+ * steps (reduce, scan, encode):
+ *
+ *  1. The exact encoded size of every chunk is computed in parallel.
+ *  2. Those sizes are scanned into the byte offset of every chunk.
+ *  3. Every chunk is encoded in parallel, straight at its offset.
+ *
+ * The output is byte for byte what vlqEncodeArray() writes, and the chunk
+ * offsets are kept in a table that lets the decoder start every chunk on a
+ * different thread.
+ */
+#pragma once
+
+// standard includes
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// third-party includes
+
+// project includes
+
+/**
+ * @brief Default number of values per chunk: large enough to amortize the
+ * thread hand-off, small enough to balance the load.
+ */
+inline constexpr size_t kVlqDefaultChunkValues = 1 << 16;
+
+/**
+ * @brief Byte offsets of the chunks of a VLQ stream.
+ *
+ * A default-constructed table describes no stream: decoding with it fails.
+ */
+struct VlqChunkTable {
+  /// Values per chunk, the last one may have fewer.
+  size_t chunkValues{kVlqDefaultChunkValues};
+  size_t count{0};              ///< Values of the whole stream.
+  std::vector<size_t> offsets;  ///< Where each chunk starts, plus the end.
+};
+
+/**
+ * @brief Encodes an array of integers into VLQ format on several threads.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @param table If not null, receives the chunk offsets for
+ * vlqDecodeArrayParallel().
+ * @param numThreads The number of threads to use, 0 for one per core.
+ * @param chunkValues The number of values per chunk, greater than 0.
+ * @return The total number of bytes used in encoding.
+ */
+size_t vlqEncodeArrayParallel(const uint32_t* values, size_t count,
+                              uint8_t* buffer, VlqChunkTable* table = nullptr,
+                              size_t numThreads = 0,
+                              size_t chunkValues = kVlqDefaultChunkValues);
+
+/**
+ * @brief Decodes a VLQ-encoded byte array on several threads.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @param table The chunk offsets written by vlqEncodeArrayParallel().
+ * @param numThreads The number of threads to use, 0 for one per core.
+ * @return The total number of bytes consumed in decoding, 0 without decoding
+ * anything if the table is empty or was built for a different count.
+ */
+size_t vlqDecodeArrayParallel(const uint8_t* buffer, size_t count,
+                              uint32_t* values, const VlqChunkTable& table,
+                              size_t numThreads = 0);
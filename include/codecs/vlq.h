@@ -6,8 +6,16 @@
 #pragma once
 
 // standard includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <vector>
 
 // third-party includes
 
@@ -49,4 +57,661 @@ size_t vlqEncodeArray(const uint32_t* values, size_t count, uint8_t* buffer);
  * @param values The output array to store decoded integers.
  * @return The total number of bytes consumed in decoding.
  */
-size_t vlqDecodeArray(const uint8_t* buffer, size_t count, uint32_t* values);
\ No newline at end of file
+size_t vlqDecodeArray(const uint8_t* buffer, size_t count, uint32_t* values);
+
+/**
+ * @brief Decodes a VLQ-encoded byte array one byte at a time.
+ *
+ * This is the reference decoder. It is used as fallback by the SIMD decoder
+ * and as baseline when testing it.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+size_t vlqDecodeArrayScalar(const uint8_t* buffer, size_t count,
+                            uint32_t* values);
+
+/**
+ * @brief Decodes a VLQ-encoded byte array with SSE4.1/AVX2 kernels.
+ *
+ * Value boundaries are found from the movemask of the continuation bits and
+ * the 7-bit groups of several values are gathered at once with shuffle
+ * tables. When the CPU has no SSE4.1 support it falls back to
+ * vlqDecodeArrayScalar(). Both produce the same result.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+size_t vlqDecodeArraySimd(const uint8_t* buffer, size_t count,
+                          uint32_t* values);
+
+/**
+ * @brief Decodes a VLQ-encoded byte array into 16-bit integers.
+ * @see vlqDecodeArraySimd(const uint8_t*, size_t, uint32_t*)
+ */
+size_t vlqDecodeArraySimd(const uint8_t* buffer, size_t count,
+                          uint16_t* values);
+
+/**
+ * @brief Decodes a VLQ-encoded byte array into 64-bit integers.
+ *
+ * Values of up to 8 bytes (56 bits) are decoded without a per-byte loop.
+ *
+ * @see vlqDecodeArraySimd(const uint8_t*, size_t, uint32_t*)
+ */
+size_t vlqDecodeArraySimd(const uint8_t* buffer, size_t count,
+                          uint64_t* values);
+
+/**
+ * @brief Decodes a LEB128-encoded byte array with SSE4.1/AVX2 kernels.
+ * @see vlqDecodeArraySimd(const uint8_t*, size_t, uint32_t*), VlqOrder
+ */
+size_t leb128DecodeArraySimd(const uint8_t* buffer, size_t count,
+                             uint32_t* values);
+
+/**
+ * @brief Decodes a LEB128-encoded byte array into 16-bit integers.
+ * @see leb128DecodeArraySimd(const uint8_t*, size_t, uint32_t*)
+ */
+size_t leb128DecodeArraySimd(const uint8_t* buffer, size_t count,
+                             uint16_t* values);
+
+/**
+ * @brief Decodes a LEB128-encoded byte array into 64-bit integers.
+ * @see leb128DecodeArraySimd(const uint8_t*, size_t, uint32_t*)
+ */
+size_t leb128DecodeArraySimd(const uint8_t* buffer, size_t count,
+                             uint64_t* values);
+
+/**
+ * @brief Encodes a 32-bit integer into LEB128 format.
+ * @see vlqEncode(), VlqOrder
+ */
+size_t leb128Encode(uint32_t value, uint8_t* buffer);
+
+/**
+ * @brief Decodes a LEB128-encoded integer.
+ * @see vlqDecode(), VlqOrder
+ */
+size_t leb128Decode(const uint8_t* buffer, uint32_t* value);
+
+/**
+ * @brief Encodes an array of integers into LEB128 format.
+ * @see vlqEncodeArray(), VlqOrder
+ */
+size_t leb128EncodeArray(const uint32_t* values, size_t count,
+                         uint8_t* buffer);
+
+/**
+ * @brief Decodes a LEB128-encoded byte array into an array of integers.
+ * @see vlqDecodeArray(), VlqOrder
+ */
+size_t leb128DecodeArray(const uint8_t* buffer, size_t count,
+                         uint32_t* values);
+
+/**
+ * @brief Order of the 7-bit groups of an encoded value.
+ *
+ * Both orders set the continuation bit (0x80) on every byte but the last one
+ * and take the same number of bytes, so value boundaries, sizes and the SIMD
+ * kernels are shared; only the group order within a value differs:
+ *
+ *     300 = 0b10'0101100   MSB first: 0x82 0x2C   LSB first: 0xAC 0x02
+ *
+ * The templated codec takes the order as a parameter, MSB first by default.
+ */
+enum class VlqOrder {
+  kMsbFirst,  ///< VLQ, as written by vlqEncode().
+  kLsbFirst,  ///< LEB128, as used by protobuf varints and DWARF.
+};
+
+/**
+ * @brief Unsigned integer types supported by the templated VLQ codec.
+ */
+template <typename T>
+concept VlqInteger = std::same_as<T, uint16_t> || std::same_as<T, uint32_t> ||
+                     std::same_as<T, uint64_t>;
+
+/**
+ * @brief Maximum number of bytes of an encoded value of type T.
+ *
+ * 3 bytes for uint16_t, 5 bytes for uint32_t and 10 bytes for uint64_t.
+ */
+template <VlqInteger T>
+inline constexpr size_t kVlqMaxBytes = (sizeof(T) * 8 + 6) / 7;
+
+/**
+ * @brief Number of bytes of the VLQ representation of a value.
+ *
+ * Computed from the count of leading zeros, without encoding the value.
+ *
+ * @param value The integer value to measure.
+ * @return The number of bytes vlqEncodeValue() writes for the value.
+ */
+template <VlqInteger T>
+constexpr size_t vlqEncodedSize(T value) {
+  // 0 still takes one byte
+  return (std::bit_width(static_cast<T>(value | 1)) + 6) / 7;
+}
+
+/**
+ * @brief Encodes an integer of type T into VLQ format.
+ *
+ * Same format for every width: the most significant 7-bit group comes first
+ * (or last, for LEB128) and every byte but the last one has the continuation
+ * bit (0x80) set. The length is computed first, so the bytes are written in
+ * their final order. It is constexpr, so it can also be used in constant
+ * expressions.
+ *
+ * @param value The integer value to encode.
+ * @param buffer The output buffer, with room for kVlqMaxBytes<T> bytes.
+ * @return The number of bytes used in the encoded representation.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+constexpr size_t vlqEncodeValue(T value, uint8_t* buffer) {
+  const size_t size = vlqEncodedSize(value);
+  for (size_t i = 0; i + 1 < size; i++) {
+    const size_t group = ORDER == VlqOrder::kMsbFirst ? size - 1 - i : i;
+    buffer[i] = 0x80 | ((value >> (7 * group)) & 0x7F);
+  }
+  const size_t lastGroup = ORDER == VlqOrder::kMsbFirst ? 0 : size - 1;
+  buffer[size - 1] = (value >> (7 * lastGroup)) & 0x7F;
+  return size;
+}
+
+/**
+ * @brief Bytes that vlqEncodeValueWide() may write at the output position.
+ */
+template <VlqInteger T>
+inline constexpr size_t kVlqWideStoreBytes =
+    std::max<size_t>(sizeof(uint64_t), kVlqMaxBytes<T>);
+
+/**
+ * @brief Encodes an integer into VLQ format with a single 8-byte store.
+ *
+ * The 7-bit groups are spread into the bytes of a 64-bit word with shifts
+ * and masks, the continuation bits are set from the length, and for VLQ the
+ * word is byte-swapped so the most significant group comes first (LEB128
+ * stores it as it is). There is no data-dependent branch except for 64-bit
+ * values wider than 56 bits, which take the byte loop.
+ *
+ * @param value The integer value to encode.
+ * @param buffer The output buffer. Bytes past the encoded value may be
+ * overwritten, so it must have room for kVlqWideStoreBytes<T> bytes.
+ * @return The number of bytes used in the encoded representation.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+inline size_t vlqEncodeValueWide(T value, uint8_t* buffer) {
+  const size_t size = vlqEncodedSize(value);
+  if constexpr (sizeof(T) == sizeof(uint64_t)) {
+    if (size > sizeof(uint64_t)) {
+      return vlqEncodeValue<T, ORDER>(value, buffer);
+    }
+  }
+  uint64_t groups = value;
+  groups = (groups & 0x000000000FFFFFFFull) |
+           ((groups & 0x00FFFFFFF0000000ull) << 4);
+  groups = (groups & 0x00003FFF00003FFFull) |
+           ((groups & 0x0FFFC0000FFFC000ull) << 2);
+  groups = (groups & 0x007F007F007F007Full) |
+           ((groups & 0x3F803F803F803F80ull) << 1);
+  const uint64_t used = ~0ull >> (64 - 8 * size);
+  uint64_t word;
+  if constexpr (ORDER == VlqOrder::kMsbFirst) {
+    // Group 0 is the last byte, every other used byte continues.
+    groups |= used & 0x8080808080808000ull;
+    word = __builtin_bswap64(groups) >> (64 - 8 * size);
+  } else {
+    // The top used group is the last byte, every lower one continues.
+    word = groups | ((used >> 8) & 0x8080808080808080ull);
+  }
+  std::memcpy(buffer, &word, sizeof(word));
+  return size;
+}
+
+/**
+ * @brief Decodes a VLQ-encoded integer of type T.
+ *
+ * It is constexpr, so it can also be used in constant expressions. Bits of
+ * over-long values that do not fit in T are dropped.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param value Pointer to store the decoded integer value.
+ * @return The number of bytes consumed in decoding.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+constexpr size_t vlqDecodeValue(const uint8_t* buffer, T* value) {
+  T result = 0;
+  size_t size = 0;
+
+  for (;;) {
+    const T group = buffer[size] & 0x7F;
+    if constexpr (ORDER == VlqOrder::kMsbFirst) {
+      result = static_cast<T>(result << 7) | group;
+    } else if (7 * size < sizeof(T) * 8) {
+      result |= static_cast<T>(group << (7 * size));
+    }
+    if (!(buffer[size] & 0x80)) {
+      break;
+    }
+    size++;
+  }
+
+  *value = result;
+  return size + 1;
+}
+
+/**
+ * @brief Encodes a constant array into VLQ bytes at compile time.
+ *
+ * The size of the result is the exact encoded size of the values, so a
+ * constexpr variable initialized with it holds only the encoded bytes, in
+ * read-only data, with no work at startup:
+ *
+ * @code
+ * constexpr auto kBytes = vlqEncodeTable<std::array{1u, 300u, 70000u}>();
+ * static_assert(kBytes.size() == 6);
+ * @endcode
+ *
+ * @tparam VALUES The values, a std::array of a VlqInteger type.
+ * @tparam ORDER The group order, VLQ by default.
+ * @return A std::array<uint8_t, N> of the encoded values.
+ */
+template <std::array VALUES, VlqOrder ORDER = VlqOrder::kMsbFirst>
+  requires VlqInteger<typename decltype(VALUES)::value_type>
+consteval auto vlqEncodeTable() {
+  using T = typename decltype(VALUES)::value_type;
+  constexpr size_t kSize = [] {
+    size_t size = 0;
+    for (T value : VALUES) {
+      size += vlqEncodedSize(value);
+    }
+    return size;
+  }();
+  std::array<uint8_t, kSize> bytes{};
+  size_t offset = 0;
+  for (T value : VALUES) {
+    offset += vlqEncodeValue<T, ORDER>(value, bytes.data() + offset);
+  }
+  return bytes;
+}
+
+/**
+ * @brief VLQ bytes of a list of 32-bit constants, encoded at compile time.
+ *
+ * @code
+ * constexpr auto& kBytes = kVlqTable<1, 300, 70000>;
+ * @endcode
+ *
+ * @see vlqEncodeTable()
+ */
+template <uint32_t... VALUES>
+inline constexpr auto kVlqTable =
+    vlqEncodeTable<std::array<uint32_t, sizeof...(VALUES)>{VALUES...}>();
+
+/**
+ * @brief Encodes an array of integers of type T into VLQ format.
+ *
+ * All but the last few values are written with vlqEncodeValueWide(), yet no
+ * byte past the encoded data is written, so the buffer needs no slack.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output buffer to store the encoded data.
+ * @return The total number of bytes used in encoding.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+size_t vlqEncodeValues(const T* values, size_t count, uint8_t* buffer) {
+  // The bytes a wide store writes past a value are rewritten by the next
+  // values, since each one takes at least a byte. Only the last values need
+  // the exact byte loop.
+  constexpr size_t kOvershoot = kVlqWideStoreBytes<T> - 1;
+  size_t totalSize = 0;
+  size_t i = 0;
+  for (; i + kOvershoot < count; i++) {
+    totalSize += vlqEncodeValueWide<T, ORDER>(values[i], buffer + totalSize);
+  }
+  for (; i < count; i++) {
+    totalSize += vlqEncodeValue<T, ORDER>(values[i], buffer + totalSize);
+  }
+  return totalSize;
+}
+
+/**
+ * @brief Decodes a VLQ-encoded byte array into integers of type T.
+ *
+ * Runs the SIMD decoder of the matching width and order.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param count The expected number of integers to decode.
+ * @param values The output array to store decoded integers.
+ * @return The total number of bytes consumed in decoding.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+size_t vlqDecodeValues(const uint8_t* buffer, size_t count, T* values) {
+  if constexpr (ORDER == VlqOrder::kMsbFirst) {
+    return vlqDecodeArraySimd(buffer, count, values);
+  } else {
+    return leb128DecodeArraySimd(buffer, count, values);
+  }
+}
+
+/**
+ * @brief Computes the exact size of the VLQ encoding of an array.
+ *
+ * Nothing is encoded: with SSE4.1, the values are shifted right 7 bits at a
+ * time and every shift that leaves a lane at zero takes one byte off the
+ * maximum size.
+ *
+ * Both group orders take the same number of bytes, so it is also the size
+ * of the LEB128 encoding.
+ *
+ * @param values The input array of integers.
+ * @param count The number of integers in the array.
+ * @return The number of bytes vlqEncodeArray() writes for the array.
+ */
+size_t vlqEncodedSizeArray(const uint32_t* values, size_t count);
+
+/**
+ * @brief Computes the exact size of the VLQ encoding of a 64-bit array.
+ * @see vlqEncodedSizeArray(const uint32_t*, size_t)
+ */
+size_t vlqEncodedSizeArray(const uint64_t* values, size_t count);
+
+/**
+ * @brief Counts the values encoded in a byte array.
+ *
+ * Every value ends with its only byte that has the continuation bit clear,
+ * so this counts those bytes: with AVX2 or SSE4.1, 32 or 16 bytes at a time
+ * from the popcount of the movemask of the continuation bits. A truncated
+ * value at the end is not counted. LEB128 has the same terminators, so it
+ * counts those values too.
+ *
+ * @param buffer The input buffer containing VLQ-encoded data.
+ * @param size The number of bytes in the buffer.
+ * @return The number of complete values in the buffer.
+ */
+size_t vlqCountValues(const uint8_t* buffer, size_t size);
+
+/**
+ * @brief Result of a decode bounded by the buffer length.
+ */
+struct VlqDecodeResult {
+  size_t consumed;  ///< Bytes of the decoded values.
+  size_t decoded;   ///< Values written to the output span.
+  bool truncated;   ///< The buffer ends inside a value.
+};
+
+/**
+ * @brief Decodes the values of a byte array of known length.
+ *
+ * The values are counted with vlqCountValues() and then decoded with
+ * vlqDecodeValues(), which reads nothing past the last value it is asked
+ * for. So the decode never reads past the end of the buffer, and a value cut
+ * by the end is left out and reported as truncated.
+ *
+ * Decoding stops early when the output span is full; the remaining bytes
+ * start at buffer[consumed].
+ *
+ * @param buffer The input span containing VLQ-encoded data.
+ * @param values The output span, vlqCountValues() values fit all of them.
+ * @return The number of bytes consumed and of values decoded, and whether
+ * the buffer ends with an incomplete value.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+VlqDecodeResult vlqDecodeValuesUntilEnd(std::span<const uint8_t> buffer,
+                                        std::span<T> values) {
+  const size_t count = std::min(
+      vlqCountValues(buffer.data(), buffer.size()), values.size());
+  return VlqDecodeResult{
+      .consumed =
+          vlqDecodeValues<T, ORDER>(buffer.data(), count, values.data()),
+      .decoded = count,
+      .truncated = !buffer.empty() && (buffer.back() & 0x80)};
+}
+
+/**
+ * @brief Decodes the values of a byte array of known length.
+ * @see vlqDecodeValuesUntilEnd()
+ */
+VlqDecodeResult vlqDecodeArrayUntilEnd(std::span<const uint8_t> buffer,
+                                       std::span<uint32_t> values);
+
+/**
+ * @brief Result of a capacity-checked encode.
+ *
+ * The output is truncated when encoded is less than the number of values
+ * given. Only whole values are written, so the remaining values can be
+ * encoded into the next buffer.
+ */
+struct VlqEncodeResult {
+  size_t encoded;  ///< Values written to the output span.
+  size_t written;  ///< Bytes written to the output span.
+};
+
+/**
+ * @brief Encodes an array of integers of type T into a bounded span.
+ *
+ * Encoding stops at the first value that does not fit. While at least
+ * kVlqWideStoreBytes<T> bytes are left, the values are written with
+ * vlqEncodeValueWide().
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The output span.
+ * @return The number of values encoded and of bytes written.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+VlqEncodeResult vlqEncodeValuesChecked(const T* values, size_t count,
+                                       std::span<uint8_t> buffer) {
+  uint8_t* out = buffer.data();
+  uint8_t* const end = out + buffer.size();
+  size_t i = 0;
+  for (; i < count && static_cast<size_t>(end - out) >= kVlqWideStoreBytes<T>;
+       i++) {
+    out += vlqEncodeValueWide<T, ORDER>(values[i], out);
+  }
+  for (; i < count; i++) {
+    if (vlqEncodedSize(values[i]) > static_cast<size_t>(end - out)) {
+      break;
+    }
+    out += vlqEncodeValue<T, ORDER>(values[i], out);
+  }
+  return VlqEncodeResult{.encoded = i,
+                         .written = static_cast<size_t>(out - buffer.data())};
+}
+
+/**
+ * @brief Encodes a 32-bit integer into a bounded span.
+ *
+ * @param value The integer value to encode.
+ * @param buffer The output span.
+ * @return The number of bytes used, or 0 if the value does not fit.
+ */
+size_t vlqEncodeChecked(uint32_t value, std::span<uint8_t> buffer);
+
+/**
+ * @brief Encodes an array of integers into a bounded span.
+ * @see vlqEncodeValuesChecked()
+ */
+VlqEncodeResult vlqEncodeArrayChecked(const uint32_t* values, size_t count,
+                                      std::span<uint8_t> buffer);
+
+/**
+ * @brief Number of values encoded per batch by the appending encoders.
+ */
+inline constexpr size_t kVlqAppendBatchValues = 256;
+
+/**
+ * @brief Computes the exact size of the VLQ encoding of an array of type T.
+ * @see vlqEncodedSizeArray(const uint32_t*, size_t)
+ */
+template <VlqInteger T>
+size_t vlqEncodedSizeValues(const T* values, size_t count) {
+  if constexpr (sizeof(T) == sizeof(uint16_t)) {
+    size_t totalSize = 0;
+    for (size_t i = 0; i < count; i++) {
+      totalSize += vlqEncodedSize(values[i]);
+    }
+    return totalSize;
+  } else {
+    return vlqEncodedSizeArray(values, count);
+  }
+}
+
+/**
+ * @brief A byte container the appending encoders can grow, such as
+ * std::vector<uint8_t>.
+ */
+template <typename B>
+concept VlqByteBuffer = requires(B& buffer, size_t size) {
+  { buffer.data() } -> std::convertible_to<uint8_t*>;
+  { buffer.size() } -> std::convertible_to<size_t>;
+  buffer.resize(size);
+};
+
+/**
+ * @brief Appends the VLQ encoding of an array to a growable buffer.
+ *
+ * The values go in batches of kVlqAppendBatchValues. The exact size of each
+ * batch is computed first, the buffer grows once for it (at least doubling
+ * its capacity when it has reserve()) and the batch is encoded through a raw
+ * pointer, with no per-byte check.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param buffer The buffer to append the encoded data to.
+ * @return The number of bytes appended.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst,
+          VlqByteBuffer BUFFER>
+size_t vlqAppendValues(const T* values, size_t count, BUFFER& buffer) {
+  const size_t start = buffer.size();
+  for (size_t i = 0; i < count; i += kVlqAppendBatchValues) {
+    const size_t batch = std::min(kVlqAppendBatchValues, count - i);
+    const size_t size = buffer.size();
+    const size_t batchSize = vlqEncodedSizeValues(values + i, batch);
+    if constexpr (requires { buffer.reserve(size), buffer.capacity(); }) {
+      if (size + batchSize > buffer.capacity()) {
+        buffer.reserve(std::max(2 * buffer.capacity(), size + batchSize));
+      }
+    }
+    buffer.resize(size + batchSize);
+    vlqEncodeValues<T, ORDER>(values + i, batch, buffer.data() + size);
+  }
+  return buffer.size() - start;
+}
+
+/**
+ * @brief Encodes an array of integers of type T through an output iterator.
+ *
+ * Batches of kVlqAppendBatchValues values are encoded into a buffer on the
+ * stack and copied to the iterator, so a back_inserter or a stream iterator
+ * sees whole batches instead of one call per encoded byte.
+ *
+ * @param values The input array of integers to encode.
+ * @param count The number of integers in the array.
+ * @param out The iterator to write the encoded bytes to.
+ * @return The iterator past the last byte written.
+ */
+template <VlqInteger T, VlqOrder ORDER = VlqOrder::kMsbFirst,
+          std::output_iterator<uint8_t> OUT>
+OUT vlqEncodeValuesTo(const T* values, size_t count, OUT out) {
+  uint8_t batchBytes[kVlqAppendBatchValues * kVlqMaxBytes<T>];
+  for (size_t i = 0; i < count; i += kVlqAppendBatchValues) {
+    const size_t size = vlqEncodeValues<T, ORDER>(
+        values + i, std::min(kVlqAppendBatchValues, count - i), batchBytes);
+    out = std::copy_n(batchBytes, size, out);
+  }
+  return out;
+}
+
+/**
+ * @brief Appends the VLQ encoding of an array to a vector.
+ * @see vlqAppendValues()
+ */
+size_t vlqEncodeArray(const uint32_t* values, size_t count,
+                      std::vector<uint8_t>& buffer);
+
+/**
+ * @brief Result of BasicVlqStreamDecoder::decode().
+ */
+struct VlqStreamResult {
+  size_t consumed;  ///< Bytes of the chunk that were used.
+  size_t decoded;   ///< Values written to the output span.
+};
+
+/**
+ * @class BasicVlqStreamDecoder
+ * @brief Decodes VLQ (or LEB128) data that arrives in arbitrary chunks.
+ *
+ * A value may be split across two (or more) chunks, e.g. when the data comes
+ * from socket or file reads. The decoder keeps the bits of the unfinished
+ * value and completes it with the next chunk, so chunks never need to be
+ * reassembled and no byte is read twice.
+ *
+ * Usage:
+ * @code
+ * VlqStreamDecoder decoder;
+ * while (auto chunk = read()) {
+ *   while (!chunk.empty()) {
+ *     auto result = decoder.decode(chunk, values);
+ *     consume(values.first(result.decoded));
+ *     chunk = chunk.subspan(result.consumed);
+ *   }
+ * }
+ * bool truncated = decoder.hasPartialValue();
+ * @endcode
+ */
+template <VlqOrder ORDER>
+class BasicVlqStreamDecoder {
+ public:
+  /**
+   * @brief Decodes the values of a chunk into a caller-supplied span.
+   *
+   * Decoding stops when the chunk is exhausted or the output span is full.
+   * In the latter case the caller resumes with the unconsumed part of the
+   * chunk.
+   *
+   * @param chunk The next bytes of the VLQ stream.
+   * @param values The output span for the decoded values.
+   * @return The number of bytes consumed and of values decoded.
+   */
+  VlqStreamResult decode(std::span<const uint8_t> chunk,
+                         std::span<uint32_t> values);
+
+  /**
+   * @brief Tells whether a value was started but not finished yet.
+   * @return true if the last chunk ended in the middle of a value.
+   */
+  bool hasPartialValue() const { return _partialBytes > 0; }
+
+  /**
+   * @brief Drops any unfinished value so a new stream can be decoded.
+   */
+  void reset() {
+    _partial = 0;
+    _partialBytes = 0;
+  }
+
+ private:
+  uint32_t _partial{0};     ///< Groups of the unfinished value so far.
+  size_t _partialBytes{0};  ///< Bytes of the unfinished value so far.
+};
+
+extern template class BasicVlqStreamDecoder<VlqOrder::kMsbFirst>;
+extern template class BasicVlqStreamDecoder<VlqOrder::kLsbFirst>;
+
+/**
+ * @brief Stream decoder for VLQ data.
+ */
+using VlqStreamDecoder = BasicVlqStreamDecoder<VlqOrder::kMsbFirst>;
+
+/**
+ * @brief Stream decoder for LEB128 data.
+ */
+using Leb128StreamDecoder = BasicVlqStreamDecoder<VlqOrder::kLsbFirst>;
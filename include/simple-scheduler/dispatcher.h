@@ -8,22 +8,39 @@
  * @brief Dispatcher Implementation
  *
  * This scheduler is designed to execute functions only once at their scheduled
- * time with a precision of 1 millisecond.
+ * time, read from the steady clock. Between tasks the dispatcher sleeps until
+ * the earliest deadline instead of polling the scheduler.
  *
  */
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
-#include <vector>
+
+#include "scheduler.h"
+#include "worker-pool.h"
 
 namespace scheduler {
 /**
  * @class Dispatcher
- * @brief Manages execution of scheduled tasks in separate threads.
+ * @brief Manages execution of scheduled tasks on a pool of worker threads.
  */
 template <typename SCHEDULER>
 class Dispatcher {
  public:
+  /**
+   * @brief Creates a dispatcher and starts its workers.
+   * @param numWorkers Number of threads running the ready tasks.
+   */
+  explicit Dispatcher(size_t numWorkers = WorkerPool::defaultNumWorkers())
+      : _pool(numWorkers) {}
+
+  /**
+   * @brief Stops the dispatcher, dropping the tasks not yet started.
+   */
+  ~Dispatcher() { stop(); }
+
   /**
    * @brief Launches a scheduler in a separate thread.
    * @param scheduler Reference to the scheduler managing tasks.
@@ -35,6 +52,7 @@ class Dispatcher {
     if (_tasksRunner != nullptr) {
       return false;
     }
+    _scheduler = scheduler;
     _tasksRunner = std::make_unique<std::thread>(
         &Dispatcher::runTasksAsScheduled, this, scheduler);
     return true;
@@ -45,59 +63,81 @@ class Dispatcher {
    * time.
    *
    * This function retrieves all functions that are ready to execute at
-   * `timeNow` from the scheduler and spawns each one in a separate detached
-   * thread.
+   * `timeNow` from the scheduler and queues them to the worker pool.
    *
    * @tparam SCHEDULER The scheduler type that manages the scheduled functions.
-   * @param timeNow The current absolute time (`std::time_t`) to check for ready
+   * @param timeNow The current time (`Clock::time_point`) to check for ready
    * tasks.
    * @param scheduler A weak pointer to the scheduler instance, allowing safe
    * access.
    *
    * @return true: Ok, false: error with scheduler, stop.
    *
-   * @note Each ready function is executed in a separate detached thread.
+   * @note Ready functions run on the long-lived workers of the pool, so a
+   * burst of expirations does not create one thread per function.
    */
-  bool spawnReady(time_t timeNow, std::weak_ptr<SCHEDULER> scheduler) {
+  bool spawnReady(TimePoint timeNow, std::weak_ptr<SCHEDULER> scheduler) {
     auto schedulerPtr = scheduler.lock();
     if (schedulerPtr == nullptr) {
       return false;
     }
-    auto functions = schedulerPtr->popReady(timeNow);
-    for (auto func : functions) {
-      std::thread newThread{func};
-      newThread.detach();
-    }
-    return true;
+    return _pool.submit(schedulerPtr->popReady(timeNow));
   }
 
   /**
    * @brief Executes scheduled tasks as per the scheduler's queue.
+   *
+   * Sleeps in SCHEDULER::waitUntilReady() between batches, for kMaxWait at
+   * most: the scheduler is only locked while waiting, so the runner exits
+   * soon after its owner drops it, even with far deadlines pending.
+   *
    * @param scheduler Reference to the scheduler managing tasks.
    */
   void runTasksAsScheduled(std::weak_ptr<SCHEDULER> scheduler) {
-    using std::chrono::system_clock;
-    using namespace std::chrono_literals;
     for (;;) {
-      time_t timeNow = system_clock::to_time_t(system_clock::now());
-      if (!spawnReady(timeNow, scheduler) || _stopFlag.load()) {
+      if (!spawnReady(Clock::now(), scheduler) || _stopFlag.load()) {
         break;
       }
-      std::this_thread::sleep_for(1ms);
+      auto schedulerPtr = scheduler.lock();
+      if (schedulerPtr == nullptr) {
+        break;
+      }
+      schedulerPtr->waitUntilReady(_stopFlag, kMaxWait);
     }
   }
 
-  void stop() {
+  /**
+   * @brief Stops launching tasks and stops the workers.
+   *
+   * Tasks already running always complete before stop() returns.
+   *
+   * @param drain true to also run the tasks already handed to the workers,
+   * false to drop those not yet started.
+   */
+  void stop(bool drain = false) {
     _stopFlag.store(true);
+    if (auto schedulerPtr = _scheduler.lock()) {
+      schedulerPtr->wakeWaiters();
+    }
 
-    if (_tasksRunner != nullptr) {
+    if (_tasksRunner != nullptr && _tasksRunner->joinable()) {
       _tasksRunner->join();
     }
+    _pool.stop(drain);
   }
 
+  /**
+   * @brief Retrieves the number of ready tasks queued or running.
+   */
+  size_t getNumInFlightTasks() const { return _pool.getNumInFlightTasks(); }
+
  private:
+  /// Longest sleep between two checks that the scheduler is still owned.
+  static constexpr Clock::duration kMaxWait = std::chrono::milliseconds(10);
+
   std::unique_ptr<std::thread> _tasksRunner;
+  std::weak_ptr<SCHEDULER> _scheduler;
   std::atomic<bool> _stopFlag{false};
-  std::vector<std::thread> _threads;
+  WorkerPool _pool;
 };
 }  // namespace scheduler
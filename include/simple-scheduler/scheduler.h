@@ -8,22 +8,75 @@
  * @brief Function Scheduler Implementation
  *
  * This scheduler is designed to execute functions only once at their scheduled
- * time with a precision of 1 millisecond.
+ * time. Times are steady_clock time points, immune to wall-clock jumps and
+ * with the resolution of the clock (nanoseconds on Linux).
  *
  */
 #pragma once
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace scheduler {
 using ScheduledFunction = std::function<void()>;
+using Clock = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
+/**
+ * @brief Identifies a scheduled task, to cancel it.
+ *
+ * Handles are small values, safe to copy and to keep after the task has run:
+ * the generation tells them apart from a later task reusing the same slot.
+ */
+struct TaskHandle {
+  uint32_t slot = UINT32_MAX;
+  uint32_t generation = 0;
+};
+
+/**
+ * @brief Notifies the threads waiting on a condition guarded by a mutex.
+ *
+ * Taking the lock orders this with a waiter between its flag check and its
+ * wait, so the notification cannot be missed.
+ */
+void notifyWaiters(std::mutex& mtx, std::condition_variable& cv);
+
+/**
+ * @brief Time point a duration from now, saturated at TimePoint::max().
+ */
+TimePoint deadlineAfter(Clock::duration wait);
+
+/**
+ * @brief Removes a task under a mutex, then destroys its function unlocked.
+ *
+ * The function is destroyed outside the lock since the closure may use the
+ * scheduler, e.g. hold the last reference to an object that cancels more.
+ *
+ * @param detach Called under the lock with an empty function; moves the
+ * task's function into it and returns true, or returns false if the task is
+ * gone.
+ * @return What detach returned.
+ */
+template <typename DETACH>
+bool cancelUnlocked(std::mutex& mtx, DETACH detach) {
+  ScheduledFunction cancelled;
+  {
+    std::lock_guard<std::mutex> guard(mtx);
+    if (!detach(cancelled)) {
+      return false;
+    }
+  }
+  cancelled = nullptr;
+  return true;
+}
+
 /**
  * @class Scheduler
  * @brief Manages scheduling and execution of functions.
@@ -34,16 +87,48 @@ class Scheduler {
   /**
    * @brief Schedules a function for execution.
    * @param func Function to be executed.
-   * @param relativeTime Delay period to wait until run the scheduled function.
+   * @param absoluteExpirationTime Time at which the function becomes ready.
+   * @return Handle to cancel the task.
    */
-  void scheduleFunction(ScheduledFunction func, time_t absoluteExpirationTime);
+  TaskHandle scheduleFunction(ScheduledFunction func,
+                              TimePoint absoluteExpirationTime);
+
+  /**
+   * @brief Cancels a task that has not been popped yet.
+   *
+   * The function is destroyed at once and no longer counted as pending. Its
+   * heap entry is left behind, marked stale by the generation, and skipped
+   * when it reaches the top; the heap is rebuilt when half of it is stale.
+   *
+   * @param handle Handle returned by scheduleFunction().
+   * @return true if cancelled, false if the task already ran or was
+   * cancelled.
+   */
+  bool cancel(TaskHandle handle);
 
   /**
    * @brief Retrieves and removes the next scheduled function if available.
-   * @param relativeTime
+   * @param absoluteTimeNow The current time.
    * @return Functions ready to be executed.
    */
-  std::vector<ScheduledFunction> popReady(std::time_t relativeTime);
+  std::vector<ScheduledFunction> popReady(TimePoint absoluteTimeNow);
+
+  /**
+   * @brief Sleeps until the earliest pending task is due.
+   *
+   * Scheduling a task with an earlier deadline than all the pending ones
+   * wakes the caller to sleep until the new deadline instead.
+   *
+   * @param stopFlag Returns early once set and wakeWaiters() is called.
+   * @param maxWait Returns after this long at most, whatever is pending.
+   */
+  void waitUntilReady(const std::atomic<bool>& stopFlag,
+                      Clock::duration maxWait = Clock::duration::max());
+
+  /**
+   * @brief Wakes the threads in waitUntilReady() to check their stop flag.
+   */
+  void wakeWaiters();
 
   /**
    * @brief Retrieves the number of pending tasks still in the scheduler.
@@ -52,17 +137,30 @@ class Scheduler {
   size_t getNumPendingTasks() const;
 
  private:
-  mutable std::mutex _mtx;
   struct ScheduleInfo {
-    std::time_t expirationTime;
-    ScheduledFunction function;
+    TimePoint expirationTime;
+    TaskHandle task;
     bool operator>(const ScheduleInfo& other) const {
       return expirationTime > other.expirationTime;
     }
   };
-  std::priority_queue<ScheduleInfo, std::vector<ScheduleInfo>,
-                      std::greater<ScheduleInfo>>
-      _minHeap;
+  struct TaskSlot {
+    ScheduledFunction function;
+    uint32_t generation = 0;
+  };
+
+  bool isStale(const ScheduleInfo& info) const;
+  ScheduledFunction release(uint32_t slot);
+  void popHeap();
+  void dropStaleTop();
+
+  mutable std::mutex _mtx;
+  std::condition_variable _earliestChanged;
+  /// Min-heap on expirationTime, kept with std::push_heap/std::pop_heap.
+  std::vector<ScheduleInfo> _minHeap;
+  std::vector<TaskSlot> _tasks;
+  std::vector<uint32_t> _freeSlots;
+  size_t _numPending = 0;
 };
 
 }  // namespace scheduler
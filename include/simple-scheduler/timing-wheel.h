@@ -0,0 +1,154 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file timing-wheel.h
+ * @brief Hierarchical Timing Wheel Scheduler
+ *
+ * Drop-in alternative to Scheduler for very many pending tasks: scheduling
+ * and expiring a task are O(1) instead of O(log n).
+ *
+ * Deadlines are counted in ticks, by default of the clock's resolution. A
+ * coarser tick batches nearby deadlines into fewer slots, at the cost of
+ * firing up to one tick late (never early).
+ *
+ * Level l of the wheel has 64 slots of 64^l ticks each, and a task is kept
+ * at the lowest level whose slots still separate its deadline from the
+ * current tick. When the current tick reaches the slot of a higher level,
+ * the slot is cascaded: its tasks are placed again, one level lower or
+ * more. Level 0 slots hold a single deadline and expire as a whole. Eleven
+ * levels cover the 64-bit tick range, so no deadline overflows the wheel,
+ * and each task cascades at most once per level.
+ *
+ */
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "scheduler.h"
+
+namespace scheduler {
+
+/**
+ * @class TimingWheelScheduler
+ * @brief Manages scheduling of functions on a hierarchical timing wheel.
+ */
+class TimingWheelScheduler {
+ public:
+  /**
+   * @brief Creates an empty wheel.
+   * @param tick Duration of a level 0 slot.
+   */
+  explicit TimingWheelScheduler(Clock::duration tick = Clock::duration{1});
+  virtual ~TimingWheelScheduler() = default;
+
+  /**
+   * @brief Schedules a function for execution.
+   * @param func Function to be executed.
+   * @param absoluteExpirationTime Time at which the function becomes ready.
+   * @return Handle to cancel the task.
+   */
+  TaskHandle scheduleFunction(ScheduledFunction func,
+                              TimePoint absoluteExpirationTime);
+
+  /**
+   * @brief Cancels a task that has not been popped yet.
+   *
+   * The task is unlinked from its slot in O(1) and its function destroyed
+   * at once.
+   *
+   * @param handle Handle returned by scheduleFunction().
+   * @return true if cancelled, false if the task already ran or was
+   * cancelled.
+   */
+  bool cancel(TaskHandle handle);
+
+  /**
+   * @brief Retrieves and removes the functions whose time has come.
+   *
+   * Time only moves forward: an earlier time than a previous call returns
+   * the functions scheduled in the past since then.
+   *
+   * @param absoluteTimeNow The current time.
+   * @return Functions ready to be executed, earliest deadline first.
+   */
+  std::vector<ScheduledFunction> popReady(TimePoint absoluteTimeNow);
+
+  /**
+   * @brief Sleeps until the next slot of the wheel is due.
+   *
+   * That is the earliest deadline, or a cascade before it, after which the
+   * caller is expected to call popReady() and wait again. Scheduling a task
+   * due before that slot wakes the caller to sleep until the new deadline.
+   *
+   * @param stopFlag Returns early once set and wakeWaiters() is called.
+   * @param maxWait Returns after this long at most, whatever is pending.
+   */
+  void waitUntilReady(const std::atomic<bool>& stopFlag,
+                      Clock::duration maxWait = Clock::duration::max());
+
+  /**
+   * @brief Wakes the threads in waitUntilReady() to check their stop flag.
+   */
+  void wakeWaiters();
+
+  /**
+   * @brief Retrieves the number of pending tasks still in the scheduler.
+   * @return Number of the tasks that were scheduled but still not run.
+   */
+  size_t getNumPendingTasks() const;
+
+ private:
+  static constexpr int kSlotBits = 6;
+  static constexpr size_t kSlots = size_t{1} << kSlotBits;
+  static constexpr int kLevels = (64 + kSlotBits - 1) / kSlotBits;
+  static constexpr uint32_t kNil = UINT32_MAX;
+  static constexpr uint16_t kDueBucket = kLevels * kSlots;
+
+  struct Node {
+    uint64_t deadline;
+    ScheduledFunction function;
+    uint32_t prev;
+    uint32_t next;
+    uint32_t generation = 0;
+    uint16_t bucket;  ///< level * kSlots + slot, or kDueBucket
+  };
+  /**
+   * @brief Doubly-linked list of nodes, appended at the tail so that tasks
+   * of equal deadline keep their scheduling order.
+   */
+  struct List {
+    uint32_t head = kNil;
+    uint32_t tail = kNil;
+  };
+
+  uint64_t toTick(Clock::duration time, bool roundUp) const;
+  uint64_t nextEventTick() const;
+  List& bucketList(uint16_t bucket);
+  void append(uint16_t bucket, uint32_t node);
+  void unlink(uint32_t node);
+  ScheduledFunction release(uint32_t node);
+  void place(uint32_t node);
+  void expire(List& list, std::vector<ScheduledFunction>& ready);
+  void processTick(std::vector<ScheduledFunction>& ready);
+
+  mutable std::mutex _mtx;
+  std::condition_variable _earliestChanged;
+  size_t _numWaiters = 0;
+  const Clock::duration _tick;
+  std::vector<Node> _nodes;
+  std::vector<uint32_t> _freeNodes;
+  std::array<std::array<List, kSlots>, kLevels> _slots;
+  std::array<uint64_t, kLevels> _occupied{};  ///< One bit per non-empty slot
+  List _due;  ///< Deadline already reached when placed
+  uint64_t _now = 0;
+  size_t _numPending = 0;
+};
+
+}  // namespace scheduler
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file worker-pool.h
+ * @brief Fixed-size pool of worker threads fed by a run queue.
+ *
+ */
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scheduler {
+using ScheduledFunction = std::function<void()>;
+
+/**
+ * @class WorkerPool
+ * @brief Runs submitted functions on a fixed set of long-lived threads.
+ *
+ * Functions are taken from the run queue in submission order by whichever
+ * worker is free. The pool counts the functions in flight, queued or
+ * running, so that stop() can either drain them or drop the queued ones.
+ */
+class WorkerPool {
+ public:
+  /**
+   * @brief Starts the workers.
+   * @param numWorkers Number of threads, at least 1.
+   */
+  explicit WorkerPool(size_t numWorkers = defaultNumWorkers());
+
+  /**
+   * @brief Stops the pool without draining it.
+   */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief One worker per hardware thread.
+   */
+  static size_t defaultNumWorkers();
+
+  /**
+   * @brief Queues a function to be run by a worker.
+   * @param func Function to be executed.
+   * @return true if queued, false if the pool has been stopped.
+   */
+  bool submit(ScheduledFunction func);
+
+  /**
+   * @brief Queues several functions at once, under a single lock.
+   * @param functions Functions to be executed, in order.
+   * @return true if queued, false if the pool has been stopped.
+   */
+  bool submit(std::vector<ScheduledFunction> functions);
+
+  /**
+   * @brief Blocks until no function is queued or running.
+   */
+  void waitIdle();
+
+  /**
+   * @brief Stops the workers.
+   *
+   * Functions already running always complete before stop() returns. It
+   * must not be called from a function run by the pool.
+   *
+   * @param drain true to run every queued function first, false to drop
+   * them.
+   */
+  void stop(bool drain = false);
+
+  /**
+   * @brief Retrieves the number of functions queued or running.
+   */
+  size_t getNumInFlightTasks() const;
+
+  /**
+   * @brief Retrieves the number of worker threads.
+   */
+  size_t getNumWorkers() const { return _numWorkers; }
+
+ private:
+  void runWorker();
+
+  mutable std::mutex _mtx;
+  std::condition_variable _ready;  ///< Work queued or stopping.
+  std::condition_variable _idle;   ///< Nothing in flight.
+  std::deque<ScheduledFunction> _queue;
+  size_t _running = 0;
+  bool _stopping = false;
+  size_t _numWorkers;
+  std::vector<std::thread> _workers;
+};
+
+}  // namespace scheduler
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file block-codec.cc
+ * @brief Implementation of blocks encoded with a format chosen per block.
+ */
+
+// standard includes
+#include <algorithm>
+
+// third-party includes
+
+// project includes
+#include "block-codec.h"
+#include "dictionary.h"
+#include "pfor.h"
+#include "stream-vbyte.h"
+#include "vlq.h"
+
+size_t blockMaxEncodedSize(size_t count) {
+  return 1 + std::max({count * kVlqMaxBytes<uint32_t>,
+                       streamVByteMaxEncodedSize(count),
+                       pforMaxEncodedSize(count),
+                       dictionaryMaxEncodedSize(count)});
+}
+
+size_t encodeBlock(BlockFormat format, const uint32_t* values, size_t count,
+                   uint8_t* buffer) {
+  buffer[0] = static_cast<uint8_t>(format);
+  switch (format) {
+    case BlockFormat::kVlq:
+      return 1 + vlqEncodeArray(values, count, buffer + 1);
+    case BlockFormat::kStreamVByte:
+      return 1 + streamVByteEncodeArray(values, count, buffer + 1);
+    case BlockFormat::kPfor:
+      return 1 + pforEncodeArray(values, count, buffer + 1);
+    case BlockFormat::kDictionary:
+      return 1 + dictionaryEncodeArray(values, count, buffer + 1);
+  }
+  return 0;
+}
+
+size_t decodeBlock(const uint8_t* buffer, size_t count, uint32_t* values) {
+  switch (static_cast<BlockFormat>(buffer[0])) {
+    case BlockFormat::kVlq:
+      return 1 + vlqDecodeArray(buffer + 1, count, values);
+    case BlockFormat::kStreamVByte:
+      return 1 + streamVByteDecodeArray(buffer + 1, count, values);
+    case BlockFormat::kPfor: {
+      const size_t size = pforDecodeArray(buffer + 1, count, values);
+      return size == 0 && count > 0 ? 0 : 1 + size;
+    }
+    case BlockFormat::kDictionary:
+      return 1 + dictionaryDecodeArray(buffer + 1, count, values);
+  }
+  return 0;
+}
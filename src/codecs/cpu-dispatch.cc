@@ -0,0 +1,122 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file cpu-dispatch.cc
+ * @brief CPU detection and the registry of the kernels to rebind.
+ */
+
+// standard includes
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CPU_HAVE_X86 1
+#endif
+
+// third-party includes
+
+// project includes
+#include "cpu-dispatch.h"
+
+namespace {
+
+constexpr const char* kTierNames[kCpuTiers] = {"scalar", "sse4.1", "avx2",
+                                               "avx512"};
+
+CpuTier detectTier() {
+#ifdef CPU_HAVE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+      __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("popcnt")) {
+    return CpuTier::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+    return CpuTier::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return CpuTier::kSse41;
+  }
+#endif
+  return CpuTier::kScalar;
+}
+
+/**
+ * @brief The detected tier, lowered by CODECS_CPU_TIER if it names a lower
+ * one.
+ */
+CpuTier startTier() {
+  const CpuTier detected = cpuDetectedTier();
+  const char* name = std::getenv("CODECS_CPU_TIER");
+  if (name == nullptr) {
+    return detected;
+  }
+  for (size_t i = 0; i < kCpuTiers; i++) {
+    if (std::strcmp(name, kTierNames[i]) == 0) {
+      return std::min(detected, static_cast<CpuTier>(i));
+    }
+  }
+  return detected;
+}
+
+/**
+ * @brief The active tier and the kernels bound to it.
+ */
+struct Registry {
+  std::mutex mtx;
+  CpuTier tier{startTier()};
+  std::vector<CpuKernelBase*> kernels;
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+}  // namespace
+
+CpuTier cpuDetectedTier() {
+  static const CpuTier tier = detectTier();
+  return tier;
+}
+
+CpuTier cpuTier() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mtx);
+  return reg.tier;
+}
+
+bool cpuForceTier(CpuTier tier) {
+  if (tier > cpuDetectedTier()) {
+    return false;
+  }
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mtx);
+  reg.tier = tier;
+  for (CpuKernelBase* kernel : reg.kernels) {
+    kernel->bind(tier);
+  }
+  return true;
+}
+
+const char* cpuTierName(CpuTier tier) {
+  return kTierNames[static_cast<size_t>(tier)];
+}
+
+CpuKernelBase::~CpuKernelBase() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mtx);
+  std::erase(reg.kernels, this);
+}
+
+void CpuKernelBase::attach() {
+  Registry& reg = registry();
+  std::lock_guard<std::mutex> guard(reg.mtx);
+  bind(reg.tier);
+  reg.kernels.push_back(this);
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file dictionary.cc
+ * @brief Implementation of dictionary encoding.
+ *
+ * The decoder unpacks the indexes of a block straight into the output array
+ * and replaces each one by its value in place, 8 at a time with an AVX2
+ * gather. Indexes are masked to the size of the dictionary array, so a
+ * corrupt block yields wrong values but never reads out of bounds.
+ */
+
+// standard includes
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DICT_HAVE_X86 1
+#endif
+
+// third-party includes
+
+// project includes
+#include "cpu-dispatch.h"
+#include "dictionary.h"
+#include "pfor.h"
+#include "vlq.h"
+
+namespace {
+
+static_assert(std::has_single_bit(kDictionaryBlockSize),
+              "indexes are masked with kDictionaryBlockSize - 1");
+
+constexpr uint32_t kIndexMask = kDictionaryBlockSize - 1;
+
+// Twice as many slots as values keeps the probe sequences short.
+constexpr int kHashBits = std::bit_width(kDictionaryBlockSize);
+constexpr size_t kHashSlots = size_t{1} << kHashBits;
+
+using Dictionary = std::array<uint32_t, kDictionaryBlockSize>;
+
+/**
+ * @class DictionaryBuilder
+ * @brief Open-addressing hash table from value to index in the dictionary.
+ */
+class DictionaryBuilder {
+ public:
+  /**
+   * @brief Replaces the values of a block by their dictionary indexes.
+   *
+   * @return The number of entries of the dictionary.
+   */
+  size_t build(const uint32_t* values, size_t count, Dictionary& entries,
+               uint32_t* indexes) {
+    _slots.fill(0);
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++) {
+      const uint32_t value = values[i];
+      size_t slot = (value * 0x9E3779B1u) >> (32 - kHashBits);
+      // Slots hold index + 1, 0 is empty.
+      while (_slots[slot] != 0 && entries[_slots[slot] - 1] != value) {
+        slot = (slot + 1) & (kHashSlots - 1);
+      }
+      if (_slots[slot] == 0) {
+        entries[size++] = value;
+        _slots[slot] = size;
+      }
+      indexes[i] = _slots[slot] - 1;
+    }
+    return size;
+  }
+
+ private:
+  std::array<uint16_t, kHashSlots> _slots;
+};
+
+void gatherScalar(const Dictionary& entries, uint32_t* values, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    values[i] = entries[values[i] & kIndexMask];
+  }
+}
+
+#ifdef DICT_HAVE_X86
+__attribute__((target("avx2"))) void gatherAvx2(const Dictionary& entries,
+                                                uint32_t* values,
+                                                size_t count) {
+  const auto* base = reinterpret_cast<const int*>(entries.data());
+  const __m256i mask = _mm256_set1_epi32(kIndexMask);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    auto* lanes = reinterpret_cast<__m256i*>(values + i);
+    const __m256i indexes = _mm256_and_si256(_mm256_loadu_si256(lanes), mask);
+    _mm256_storeu_si256(lanes, _mm256_i32gather_epi32(base, indexes, 4));
+  }
+  gatherScalar(entries, values + i, count - i);
+}
+#endif  // DICT_HAVE_X86
+
+void gather(const Dictionary& entries, uint32_t* values, size_t count) {
+  using Kernel = void (*)(const Dictionary&, uint32_t*, size_t);
+#ifdef DICT_HAVE_X86
+  static CpuKernel<Kernel> kernel(
+      {gatherScalar, nullptr, gatherAvx2, nullptr});
+#else
+  static CpuKernel<Kernel> kernel({gatherScalar, nullptr, nullptr, nullptr});
+#endif
+  kernel(entries, values, count);
+}
+
+}  // namespace
+
+size_t dictionaryEncodeArray(const uint32_t* values, size_t count,
+                             uint8_t* buffer) {
+  DictionaryBuilder builder;
+  Dictionary entries;
+  std::array<uint32_t, kDictionaryBlockSize> indexes;
+  uint8_t* out = buffer;
+  for (size_t i = 0; i < count; i += kDictionaryBlockSize) {
+    const size_t blockCount = std::min(kDictionaryBlockSize, count - i);
+    const size_t size =
+        builder.build(values + i, blockCount, entries, indexes.data());
+    out += vlqEncode(size, out);
+    out += vlqEncodeArray(entries.data(), size, out);
+    out += pforEncodeArray(indexes.data(), blockCount, out);
+  }
+  return out - buffer;
+}
+
+size_t dictionaryDecodeArray(const uint8_t* buffer, size_t count,
+                             uint32_t* values) {
+  Dictionary entries{};
+  const uint8_t* in = buffer;
+  for (size_t i = 0; i < count; i += kDictionaryBlockSize) {
+    const size_t blockCount = std::min(kDictionaryBlockSize, count - i);
+    uint32_t size;
+    in += vlqDecode(in, &size);
+    in += vlqDecodeArray(in, std::min<size_t>(size, kDictionaryBlockSize),
+                         entries.data());
+    in += pforDecodeArray(in, blockCount, values + i);
+    gather(entries, values + i, blockCount);
+  }
+  return in - buffer;
+}
@@ -0,0 +1,337 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file pfor.cc
+ * @brief Implementation of patched frame-of-reference encoding.
+ *
+ * The SIMD paths have one kernel per bit width, so every shift is a constant
+ * and the 32 steps of a block are fully unrolled. A kernel handles one
+ * 128-bit word of 4 lanes per step: while packing, lanes are shifted into
+ * place and OR-ed together until the word is full; while unpacking, they are
+ * shifted out and masked, taking the missing high bits from the next word
+ * when a value straddles two.
+ */
+
+// standard includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// third-party includes
+
+// project includes
+#include "pfor.h"
+#include "vlq.h"
+
+namespace {
+
+constexpr size_t kHeaderBytes = 6;
+constexpr size_t kMaxBits = 32;
+constexpr size_t kLaneValues = kPforBlockSize / 4;  ///< Values per lane.
+
+using PackFunction = void (*)(const uint32_t* values, uint32_t reference,
+                              unsigned bits, uint8_t* out);
+using UnpackFunction = void (*)(const uint8_t* in, uint32_t reference,
+                                unsigned bits, uint32_t* values);
+
+constexpr uint32_t lowMask(unsigned bits) {
+  return bits == kMaxBits ? ~0u : (1u << bits) - 1;
+}
+
+/**
+ * @brief Bytes of the packed data of a block.
+ */
+constexpr size_t packedBytes(unsigned bits) {
+  return kPforBlockSize * bits / 8;
+}
+
+/**
+ * @brief Finds the bit width that gives the smallest block.
+ *
+ * Every value wider than the bit width costs a position byte plus the VLQ
+ * bytes of its high bits, which only depend on its width.
+ */
+unsigned chooseBits(const uint32_t* values, uint32_t reference) {
+  std::array<size_t, kMaxBits + 1> widths{};
+  unsigned maxWidth = 0;
+  for (size_t i = 0; i < kPforBlockSize; i++) {
+    const unsigned width = std::bit_width(values[i] - reference);
+    widths[width]++;
+    maxWidth = std::max(maxWidth, width);
+  }
+  unsigned best = maxWidth;
+  size_t bestCost = packedBytes(maxWidth);
+  for (unsigned bits = maxWidth; bits-- > 0;) {
+    size_t cost = packedBytes(bits);
+    for (unsigned width = bits + 1; width <= maxWidth; width++) {
+      cost += widths[width] * (1 + (width - bits + 6) / 7);
+    }
+    if (cost < bestCost) {
+      best = bits;
+      bestCost = cost;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Packs the low bits of a block, one value at a time.
+ */
+void packScalar(const uint32_t* values, uint32_t reference, unsigned bits,
+                uint8_t* out) {
+  std::array<uint32_t, kPforBlockSize> words{};
+  for (size_t i = 0; i < kPforBlockSize; i++) {
+    const uint32_t delta = (values[i] - reference) & lowMask(bits);
+    const size_t lane = i % 4;
+    const size_t offset = i / 4 * bits;
+    const size_t word = offset / 32;
+    const size_t shift = offset % 32;
+    words[4 * word + lane] |= delta << shift;
+    if (shift + bits > 32) {
+      words[4 * (word + 1) + lane] |= delta >> (32 - shift);
+    }
+  }
+  std::memcpy(out, words.data(), packedBytes(bits));
+}
+
+/**
+ * @brief Unpacks the low bits of a block, one value at a time.
+ */
+void unpackScalar(const uint8_t* in, uint32_t reference, unsigned bits,
+                  uint32_t* values) {
+  std::array<uint32_t, kPforBlockSize> words{};
+  std::memcpy(words.data(), in, packedBytes(bits));
+  for (size_t i = 0; i < kPforBlockSize; i++) {
+    const size_t lane = i % 4;
+    const size_t offset = i / 4 * bits;
+    const size_t word = offset / 32;
+    const size_t shift = offset % 32;
+    uint32_t delta = words[4 * word + lane] >> shift;
+    if (shift + bits > 32) {
+      delta |= words[4 * (word + 1) + lane] << (32 - shift);
+    }
+    values[i] = (delta & lowMask(bits)) + reference;
+  }
+}
+
+/**
+ * @brief Encodes a full block.
+ * @return Pointer past the last byte written.
+ */
+uint8_t* encodeBlock(const uint32_t* values, uint8_t* out, PackFunction pack) {
+  const uint32_t reference =
+      *std::min_element(values, values + kPforBlockSize);
+  const unsigned bits = chooseBits(values, reference);
+  std::memcpy(out, &reference, sizeof(reference));
+  out[4] = bits;
+
+  uint8_t* packed = out + kHeaderBytes;
+  pack(values, reference, bits, packed);
+
+  uint8_t* positions = packed + packedBytes(bits);
+  size_t numExceptions = 0;
+  if (bits < kMaxBits) {
+    // Branch-free: the position is always written, but only kept if the
+    // value is an exception. A block with exceptions is smaller than one of
+    // 32 bits, so the extra byte stays within pforMaxEncodedSize().
+    for (size_t i = 0; i < kPforBlockSize; i++) {
+      positions[numExceptions] = i;
+      numExceptions += ((values[i] - reference) >> bits) != 0;
+    }
+  }
+  out[5] = numExceptions;
+
+  uint8_t* high = positions + numExceptions;
+  for (size_t i = 0; i < numExceptions; i++) {
+    high += vlqEncodeValue<uint32_t>(
+        (values[positions[i]] - reference) >> bits, high);
+  }
+  return high;
+}
+
+/**
+ * @brief Decodes a full block.
+ * @return Pointer past the last byte read, or nullptr if the header is
+ * corrupt.
+ */
+const uint8_t* decodeBlock(const uint8_t* in, uint32_t* values,
+                           UnpackFunction unpack) {
+  uint32_t reference;
+  std::memcpy(&reference, in, sizeof(reference));
+  const unsigned bits = in[4];
+  const size_t numExceptions = in[5];
+  // The bit width indexes the unpack kernels: never trust it. A full width
+  // block has no exceptions, and no exception lies outside the block.
+  if (bits > kMaxBits || (bits == kMaxBits && numExceptions > 0)) {
+    return nullptr;
+  }
+
+  const uint8_t* packed = in + kHeaderBytes;
+  const uint8_t* positions = packed + packedBytes(bits);
+  for (size_t i = 0; i < numExceptions; i++) {
+    if (positions[i] >= kPforBlockSize) {
+      return nullptr;
+    }
+  }
+  unpack(packed, reference, bits, values);
+
+  const uint8_t* high = positions + numExceptions;
+  for (size_t i = 0; i < numExceptions; i++) {
+    uint32_t highBits;
+    high += vlqDecodeValue<uint32_t>(high, &highBits);
+    values[positions[i]] += highBits << bits;
+  }
+  return high;
+}
+
+size_t encodeArray(const uint32_t* values, size_t count, uint8_t* buffer,
+                   PackFunction pack) {
+  uint8_t* out = buffer;
+  size_t i = 0;
+  for (; i + kPforBlockSize <= count; i += kPforBlockSize) {
+    out = encodeBlock(values + i, out, pack);
+  }
+  out += vlqEncodeArray(values + i, count - i, out);
+  return out - buffer;
+}
+
+size_t decodeArray(const uint8_t* buffer, size_t count, uint32_t* values,
+                   UnpackFunction unpack) {
+  const uint8_t* in = buffer;
+  size_t i = 0;
+  for (; i + kPforBlockSize <= count; i += kPforBlockSize) {
+    in = decodeBlock(in, values + i, unpack);
+    if (in == nullptr) {
+      return 0;
+    }
+  }
+  in += vlqDecodeArray(in, count - i, values + i);
+  return in - buffer;
+}
+
+}  // namespace
+
+#ifdef __SSE2__
+namespace {
+
+template <unsigned BITS>
+void packSse2(const uint32_t* values, uint32_t reference, uint8_t* out) {
+  if constexpr (BITS > 0) {
+    const __m128i base = _mm_set1_epi32(reference);
+    const __m128i mask = _mm_set1_epi32(lowMask(BITS));
+    auto* words = reinterpret_cast<__m128i*>(out);
+    __m128i word = _mm_setzero_si128();
+#pragma GCC unroll 32
+    for (unsigned j = 0; j < kLaneValues; j++) {
+      __m128i lanes = _mm_sub_epi32(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + 4 * j)),
+          base);
+      if constexpr (BITS < kMaxBits) {
+        lanes = _mm_and_si128(lanes, mask);
+      }
+      const unsigned shift = j * BITS % 32;
+      word = _mm_or_si128(word, _mm_slli_epi32(lanes, shift));
+      if (shift + BITS >= 32) {
+        _mm_storeu_si128(words++, word);
+        word = shift + BITS > 32 ? _mm_srli_epi32(lanes, 32 - shift)
+                                 : _mm_setzero_si128();
+      }
+    }
+  }
+}
+
+template <unsigned BITS>
+void unpackSse2(const uint8_t* in, uint32_t reference, uint32_t* values) {
+  const __m128i base = _mm_set1_epi32(reference);
+  auto* out = reinterpret_cast<__m128i*>(values);
+  if constexpr (BITS == 0) {
+    for (unsigned j = 0; j < kLaneValues; j++) {
+      _mm_storeu_si128(out + j, base);
+    }
+  } else {
+    const __m128i mask = _mm_set1_epi32(lowMask(BITS));
+    const auto* words = reinterpret_cast<const __m128i*>(in);
+    __m128i word = _mm_loadu_si128(words++);
+#pragma GCC unroll 32
+    for (unsigned j = 0; j < kLaneValues; j++) {
+      const unsigned shift = j * BITS % 32;
+      __m128i lanes = _mm_srli_epi32(word, shift);
+      // The last value always ends on a word boundary.
+      if (shift + BITS >= 32 && j + 1 < kLaneValues) {
+        word = _mm_loadu_si128(words++);
+        if (shift + BITS > 32) {
+          lanes = _mm_or_si128(lanes, _mm_slli_epi32(word, 32 - shift));
+        }
+      }
+      if constexpr (BITS < kMaxBits) {
+        lanes = _mm_and_si128(lanes, mask);
+      }
+      _mm_storeu_si128(out + j, _mm_add_epi32(lanes, base));
+    }
+  }
+}
+
+template <size_t... BITS>
+constexpr auto packKernels(std::index_sequence<BITS...>) {
+  using Kernel = void (*)(const uint32_t*, uint32_t, uint8_t*);
+  return std::array<Kernel, sizeof...(BITS)>{packSse2<BITS>...};
+}
+
+template <size_t... BITS>
+constexpr auto unpackKernels(std::index_sequence<BITS...>) {
+  using Kernel = void (*)(const uint8_t*, uint32_t, uint32_t*);
+  return std::array<Kernel, sizeof...(BITS)>{unpackSse2<BITS>...};
+}
+
+constexpr auto kPackKernels =
+    packKernels(std::make_index_sequence<kMaxBits + 1>());
+constexpr auto kUnpackKernels =
+    unpackKernels(std::make_index_sequence<kMaxBits + 1>());
+
+void packSimd(const uint32_t* values, uint32_t reference, unsigned bits,
+              uint8_t* out) {
+  kPackKernels[bits](values, reference, out);
+}
+
+void unpackSimd(const uint8_t* in, uint32_t reference, unsigned bits,
+                uint32_t* values) {
+  kUnpackKernels[bits](in, reference, values);
+}
+
+}  // namespace
+#endif  // __SSE2__
+
+size_t pforEncodeArray(const uint32_t* values, size_t count, uint8_t* buffer) {
+#ifdef __SSE2__
+  return encodeArray(values, count, buffer, packSimd);
+#else
+  return pforEncodeArrayScalar(values, count, buffer);
+#endif
+}
+
+size_t pforDecodeArray(const uint8_t* buffer, size_t count, uint32_t* values) {
+#ifdef __SSE2__
+  return decodeArray(buffer, count, values, unpackSimd);
+#else
+  return pforDecodeArrayScalar(buffer, count, values);
+#endif
+}
+
+size_t pforEncodeArrayScalar(const uint32_t* values, size_t count,
+                             uint8_t* buffer) {
+  return encodeArray(values, count, buffer, packScalar);
+}
+
+size_t pforDecodeArrayScalar(const uint8_t* buffer, size_t count,
+                             uint32_t* values) {
+  return decodeArray(buffer, count, values, unpackScalar);
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file stream-vbyte.cc
+ * @brief Implementation of Stream VByte encoding and decoding.
+ *
+ * The SIMD paths work on groups of 4 values:
+ *  - Decoding looks up a shuffle from the control byte that moves the 1 to 4
+ *    data bytes of each value to its own 32-bit lane.
+ *  - Encoding finds the zero bytes of the 4 values with a single compare,
+ *    turns the mask into a control byte and looks up the inverse shuffle,
+ *    which packs the used bytes together.
+ */
+
+// standard includes
+#include <array>
+#include <bit>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SVB_HAVE_X86 1
+#endif
+
+// third-party includes
+
+// project includes
+#include "cpu-dispatch.h"
+#include "stream-vbyte.h"
+
+namespace {
+
+/**
+ * @brief Number of bytes of a value in the data stream (1 to 4).
+ */
+constexpr size_t byteLength(uint32_t value) {
+  return (std::bit_width(value | 1) + 7) / 8;
+}
+
+/**
+ * @brief Encodes values one at a time, starting at a group boundary.
+ * @return Pointer past the last data byte written.
+ */
+uint8_t* encodeScalar(const uint32_t* values, size_t count, uint8_t* control,
+                      uint8_t* data) {
+  for (size_t i = 0; i < count; i++) {
+    if (i % 4 == 0) {
+      control[i / 4] = 0;
+    }
+    const uint32_t value = values[i];
+    const size_t size = byteLength(value);
+    control[i / 4] |= (size - 1) << (2 * (i % 4));
+    for (size_t j = 0; j < size; j++) {
+      data[j] = value >> (8 * j);
+    }
+    data += size;
+  }
+  return data;
+}
+
+/**
+ * @brief Decodes values one at a time, starting at a group boundary.
+ * @return Pointer past the last data byte read.
+ */
+const uint8_t* decodeScalar(const uint8_t* control, const uint8_t* data,
+                            size_t count, uint32_t* values) {
+  for (size_t i = 0; i < count; i++) {
+    const size_t size = ((control[i / 4] >> (2 * (i % 4))) & 0x3) + 1;
+    uint32_t value = 0;
+    for (size_t j = 0; j < size; j++) {
+      value |= static_cast<uint32_t>(data[j]) << (8 * j);
+    }
+    values[i] = value;
+    data += size;
+  }
+  return data;
+}
+
+}  // namespace
+
+#ifdef SVB_HAVE_X86
+namespace {
+
+struct ShuffleTables {
+  std::array<std::array<uint8_t, 16>, 256> decode;  ///< data -> lanes
+  std::array<std::array<uint8_t, 16>, 256> encode;  ///< lanes -> data
+  std::array<uint8_t, 256> lengths;  ///< Data bytes of a group.
+  std::array<uint8_t, 256> codes;    ///< Non-zero bytes of 2 lanes -> codes.
+};
+
+constexpr ShuffleTables buildTables() {
+  ShuffleTables tables{};
+  for (size_t control = 0; control < 256; control++) {
+    auto& decode = tables.decode[control];
+    auto& encode = tables.encode[control];
+    decode.fill(0x80);  // pshufb writes zero for indexes with MSB set
+    encode.fill(0x80);
+    uint8_t offset = 0;
+    for (uint8_t lane = 0; lane < 4; lane++) {
+      const uint8_t size = ((control >> (2 * lane)) & 0x3) + 1;
+      for (uint8_t j = 0; j < size; j++) {
+        decode[4 * lane + j] = offset + j;
+        encode[offset + j] = 4 * lane + j;
+      }
+      offset += size;
+    }
+    tables.lengths[control] = offset;
+
+    // Index: one bit per non-zero byte of 2 lanes. The code of a lane is the
+    // position of its highest non-zero byte.
+    const uint8_t low = control & 0xF;
+    const uint8_t high = control >> 4;
+    const uint8_t lowCode = low == 0 ? 0 : std::bit_width(low) - 1;
+    const uint8_t highCode = high == 0 ? 0 : std::bit_width(high) - 1;
+    tables.codes[control] = lowCode | (highCode << 2);
+  }
+  return tables;
+}
+
+alignas(16) constexpr ShuffleTables kTables = buildTables();
+
+// A group takes at least 4 data bytes, so while 4 groups are left, 16 bytes
+// can be loaded or stored at the data pointer.
+constexpr size_t kSafeValues = 16;
+
+__attribute__((target("sse4.1"))) size_t encodeSse41(const uint32_t* values,
+                                                     size_t count,
+                                                     uint8_t* buffer) {
+  uint8_t* control = buffer;
+  uint8_t* data = buffer + (count + 3) / 4;
+  size_t i = 0;
+  for (; i + kSafeValues <= count; i += 4) {
+    const __m128i lanes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+    const uint32_t nonZero =
+        ~_mm_movemask_epi8(_mm_cmpeq_epi8(lanes, _mm_setzero_si128()));
+    const uint8_t code = kTables.codes[nonZero & 0xFF] |
+                         (kTables.codes[(nonZero >> 8) & 0xFF] << 4);
+    const __m128i shuffle = _mm_load_si128(
+        reinterpret_cast<const __m128i*>(kTables.encode[code].data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data),
+                     _mm_shuffle_epi8(lanes, shuffle));
+    *control++ = code;
+    data += kTables.lengths[code];
+  }
+  return encodeScalar(values + i, count - i, control, data) - buffer;
+}
+
+__attribute__((target("sse4.1"))) size_t decodeSse41(const uint8_t* buffer,
+                                                     size_t count,
+                                                     uint32_t* values) {
+  const uint8_t* control = buffer;
+  const uint8_t* data = buffer + (count + 3) / 4;
+  size_t i = 0;
+  for (; i + kSafeValues <= count; i += 4) {
+    const uint8_t code = *control++;
+    const __m128i shuffle = _mm_load_si128(
+        reinterpret_cast<const __m128i*>(kTables.decode[code].data()));
+    const __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i),
+                     _mm_shuffle_epi8(bytes, shuffle));
+    data += kTables.lengths[code];
+  }
+  return decodeScalar(control, data, count - i, values + i) - buffer;
+}
+
+}  // namespace
+#endif  // SVB_HAVE_X86
+
+size_t streamVByteEncodeArray(const uint32_t* values, size_t count,
+                              uint8_t* buffer) {
+  using Kernel = size_t (*)(const uint32_t*, size_t, uint8_t*);
+#ifdef SVB_HAVE_X86
+  static CpuKernel<Kernel> kernel(
+      {streamVByteEncodeArrayScalar, encodeSse41, nullptr, nullptr});
+#else
+  static CpuKernel<Kernel> kernel(
+      {streamVByteEncodeArrayScalar, nullptr, nullptr, nullptr});
+#endif
+  return kernel(values, count, buffer);
+}
+
+size_t streamVByteDecodeArray(const uint8_t* buffer, size_t count,
+                              uint32_t* values) {
+  using Kernel = size_t (*)(const uint8_t*, size_t, uint32_t*);
+#ifdef SVB_HAVE_X86
+  static CpuKernel<Kernel> kernel(
+      {streamVByteDecodeArrayScalar, decodeSse41, nullptr, nullptr});
+#else
+  static CpuKernel<Kernel> kernel(
+      {streamVByteDecodeArrayScalar, nullptr, nullptr, nullptr});
+#endif
+  return kernel(buffer, count, values);
+}
+
+size_t streamVByteEncodeArrayScalar(const uint32_t* values, size_t count,
+                                    uint8_t* buffer) {
+  uint8_t* data = buffer + (count + 3) / 4;
+  return encodeScalar(values, count, buffer, data) - buffer;
+}
+
+size_t streamVByteDecodeArrayScalar(const uint8_t* buffer, size_t count,
+                                    uint32_t* values) {
+  const uint8_t* data = buffer + (count + 3) / 4;
+  return decodeScalar(buffer, data, count, values) - buffer;
+}
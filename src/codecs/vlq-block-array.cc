@@ -0,0 +1,149 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-block-array.cc
+ * @brief Implementation of the VLQ-encoded array with a block index.
+ */
+
+// standard includes
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// third-party includes
+
+// project includes
+#include "vlq-block-array.h"
+#include "vlq.h"
+
+namespace {
+
+/**
+ * @brief Skips a number of encoded values.
+ *
+ * Terminator bytes (high bit clear) are counted 8 bytes at a time, so only
+ * the last word is looked at byte by byte.
+ *
+ * @param in The start of an encoded value.
+ * @param end The end of the encoded data.
+ * @param count The number of values to skip.
+ * @return Pointer to the value after the skipped ones.
+ */
+const uint8_t* skipValues(const uint8_t* in, const uint8_t* end,
+                          size_t count) {
+  while (count > 0 && end - in >= 8) {
+    uint64_t word;
+    std::memcpy(&word, in, sizeof(word));
+    uint64_t stops = ~word & 0x8080808080808080ull;
+    const size_t numStops = std::popcount(stops);
+    if (numStops >= count) {
+      // Drop the stops before the last one to skip, then go past it.
+      for (size_t i = 1; i < count; i++) {
+        stops &= stops - 1;
+      }
+      return in + std::countr_zero(stops) / 8 + 1;
+    }
+    count -= numStops;
+    in += 8;
+  }
+  for (; count > 0; in++) {
+    if (!(*in & 0x80)) {
+      count--;
+    }
+  }
+  return in;
+}
+
+}  // namespace
+
+VlqBlockArray::VlqBlockArray(const uint32_t* values, size_t count,
+                             size_t blockSize, bool indexFirstValues)
+    : _count(count), _blockSize(blockSize) {
+  const size_t encodedSize = vlqEncodedSizeArray(values, count);
+  if (encodedSize > std::numeric_limits<uint32_t>::max()) {
+    throw std::length_error("VlqBlockArray: more than 4 GiB encoded");
+  }
+  _data.resize(encodedSize);
+  const size_t numBlocks = (count + blockSize - 1) / blockSize;
+  _offsets.reserve(numBlocks);
+  size_t size = 0;
+  for (size_t first = 0; first < count; first += blockSize) {
+    _offsets.push_back(static_cast<uint32_t>(size));  // Checked above
+    if (indexFirstValues) {
+      _firstValues.push_back(values[first]);
+    }
+    const size_t blockCount = std::min(blockSize, count - first);
+    size += vlqEncodeArray(values + first, blockCount, _data.data() + size);
+  }
+}
+
+size_t VlqBlockArray::encodedSize() const {
+  return _data.size() + _offsets.size() * sizeof(uint32_t) +
+         _firstValues.size() * sizeof(uint32_t);
+}
+
+const uint8_t* VlqBlockArray::locate(size_t index) const {
+  const uint8_t* block = _data.data() + _offsets[index / _blockSize];
+  return skipValues(block, _data.data() + _data.size(), index % _blockSize);
+}
+
+uint32_t VlqBlockArray::firstValue(size_t block) const {
+  if (!_firstValues.empty()) {
+    return _firstValues[block];
+  }
+  uint32_t value;
+  vlqDecode(_data.data() + _offsets[block], &value);
+  return value;
+}
+
+uint32_t VlqBlockArray::get(size_t index) const {
+  uint32_t value;
+  vlqDecode(locate(index), &value);
+  return value;
+}
+
+size_t VlqBlockArray::decodeRange(size_t first, size_t count,
+                                  uint32_t* values) const {
+  if (first >= _count) {
+    return 0;
+  }
+  count = std::min(count, _count - first);
+  // The blocks are contiguous, so the range is decoded in one call.
+  vlqDecodeArray(locate(first), count, values);
+  return count;
+}
+
+size_t VlqBlockArray::lowerBound(uint32_t value) const {
+  // Last block whose first value is < value; the answer is in that block or
+  // at the start of the next one.
+  size_t low = 0;
+  size_t high = _offsets.size();
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (firstValue(middle) < value) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == 0) {
+    return 0;
+  }
+  const size_t block = low - 1;
+  const size_t first = block * _blockSize;
+  const size_t blockCount = std::min(_blockSize, _count - first);
+  const uint8_t* in = _data.data() + _offsets[block];
+  for (size_t i = 0; i < blockCount; i++) {
+    uint32_t decoded;
+    in += vlqDecode(in, &decoded);
+    if (decoded >= value) {
+      return first + i;
+    }
+  }
+  return first + blockCount;
+}
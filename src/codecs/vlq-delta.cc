@@ -0,0 +1,129 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-delta.cc
+ * @brief Implementation of delta and zigzag coding fused with VLQ.
+ */
+
+// standard includes
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// third-party includes
+
+// project includes
+#include "vlq-delta.h"
+#include "vlq.h"
+
+namespace {
+
+// Values decoded before they are summed; 4 KiB of output stays in L1.
+constexpr size_t kBlockValues = 1024;
+
+/**
+ * @brief Encodes the deltas of an array, computed on the fly.
+ *
+ * @tparam ZIGZAG Whether the deltas are zigzag mapped.
+ */
+template <bool ZIGZAG>
+size_t encodeDeltas(const uint32_t* values, size_t count, uint8_t* buffer) {
+  // Same split as vlqEncodeValues(): wide stores while enough values follow
+  // to rewrite their overshoot.
+  constexpr size_t kOvershoot = kVlqWideStoreBytes<uint32_t> - 1;
+  size_t totalSize = 0;
+  uint32_t previous = 0;
+  for (size_t i = 0; i < count; i++) {
+    uint32_t delta = values[i] - previous;
+    if constexpr (ZIGZAG) {
+      delta = zigzagEncode(static_cast<int32_t>(delta));
+    }
+    previous = values[i];
+    if (i + kOvershoot < count) {
+      totalSize += vlqEncodeValueWide(delta, buffer + totalSize);
+    } else {
+      totalSize += vlqEncodeValue(delta, buffer + totalSize);
+    }
+  }
+  return totalSize;
+}
+
+/**
+ * @brief Turns deltas into values in place (inclusive prefix sum).
+ *
+ * @param previous The value before the first delta.
+ * @return The last value.
+ */
+template <bool ZIGZAG>
+uint32_t prefixSum(uint32_t* values, size_t count, uint32_t previous) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  __m128i carry = _mm_set1_epi32(previous);
+  for (; i + 4 <= count; i += 4) {
+    auto* lanes = reinterpret_cast<__m128i*>(values + i);
+    __m128i sum = _mm_loadu_si128(lanes);
+    if constexpr (ZIGZAG) {
+      const __m128i sign = _mm_sub_epi32(
+          _mm_setzero_si128(), _mm_and_si128(sum, _mm_set1_epi32(1)));
+      sum = _mm_xor_si128(_mm_srli_epi32(sum, 1), sign);
+    }
+    // [a b c d] -> [a a+b b+c c+d] -> [a a+b a+b+c a+b+c+d]
+    sum = _mm_add_epi32(sum, _mm_slli_si128(sum, 4));
+    sum = _mm_add_epi32(sum, _mm_slli_si128(sum, 8));
+    sum = _mm_add_epi32(sum, carry);
+    _mm_storeu_si128(lanes, sum);
+    carry = _mm_shuffle_epi32(sum, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  previous = _mm_cvtsi128_si32(carry);
+#endif
+  for (; i < count; i++) {
+    uint32_t delta = values[i];
+    if constexpr (ZIGZAG) {
+      delta = zigzagDecode(delta);
+    }
+    previous += delta;
+    values[i] = previous;
+  }
+  return previous;
+}
+
+template <bool ZIGZAG>
+size_t decodeDeltas(const uint8_t* buffer, size_t count, uint32_t* values) {
+  size_t totalSize = 0;
+  uint32_t previous = 0;
+  for (size_t i = 0; i < count; i += kBlockValues) {
+    const size_t blockCount = std::min(kBlockValues, count - i);
+    totalSize += vlqDecodeArraySimd(buffer + totalSize, blockCount, values + i);
+    previous = prefixSum<ZIGZAG>(values + i, blockCount, previous);
+  }
+  return totalSize;
+}
+
+}  // namespace
+
+size_t vlqEncodeDeltaArray(const uint32_t* values, size_t count,
+                           uint8_t* buffer) {
+  return encodeDeltas<false>(values, count, buffer);
+}
+
+size_t vlqDecodeDeltaArray(const uint8_t* buffer, size_t count,
+                           uint32_t* values) {
+  return decodeDeltas<false>(buffer, count, values);
+}
+
+size_t vlqEncodeZigzagDeltaArray(const int32_t* values, size_t count,
+                                 uint8_t* buffer) {
+  return encodeDeltas<true>(reinterpret_cast<const uint32_t*>(values), count,
+                            buffer);
+}
+
+size_t vlqDecodeZigzagDeltaArray(const uint8_t* buffer, size_t count,
+                                 int32_t* values) {
+  return decodeDeltas<true>(buffer, count,
+                            reinterpret_cast<uint32_t*>(values));
+}
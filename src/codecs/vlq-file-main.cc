@@ -0,0 +1,308 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-file-main.cc
+ * @brief Compresses raw uint32 files to VLQ and back.
+ *
+ * Usage:
+ *   vlq-file-main compress <raw-input> <vlq-output>
+ *   vlq-file-main decompress <vlq-input> <raw-output>
+ *
+ * A raw file holds little-endian uint32 values. A VLQ file holds the number
+ * of values (8 bytes, little-endian) followed by the vlqEncodeArray() stream.
+ *
+ * The input is memory-mapped and processed in windows of kWindowValues
+ * values. Pages are released once their window is done and the output goes
+ * through a fixed-size buffer, so memory use does not grow with the file.
+ */
+
+// standard includes
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+// third-party includes
+
+// project includes
+#include "vlq.h"
+
+namespace {
+
+constexpr size_t kWindowValues = 1 << 20;  ///< 4 MiB of raw values.
+constexpr size_t kHeaderBytes = sizeof(uint64_t);
+
+static_assert(std::endian::native == std::endian::little,
+              "raw files are read in place as little-endian uint32");
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path) {
+    _fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (_fd < 0 || ::fstat(_fd, &info) != 0) {
+      return;
+    }
+    _size = info.st_size;
+    _device = info.st_dev;
+    _inode = info.st_ino;
+    if (_size == 0) {
+      _valid = true;
+      return;
+    }
+    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if (data == MAP_FAILED) {
+      return;
+    }
+    _data = static_cast<const uint8_t*>(data);
+    ::madvise(data, _size, MADV_SEQUENTIAL);
+    _valid = true;
+  }
+
+  ~MappedFile() {
+    if (_data != nullptr) {
+      ::munmap(const_cast<uint8_t*>(_data), _size);
+    }
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  bool valid() const { return _valid; }
+  std::span<const uint8_t> bytes() const { return {_data, _size}; }
+
+  /**
+   * @brief Whether the path names this file, by device and inode.
+   */
+  bool isSameFile(const std::string& path) const {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0 && info.st_dev == _device &&
+           info.st_ino == _inode;
+  }
+
+  /**
+   * @brief Drops the pages entirely before the given offset from memory.
+   */
+  void release(size_t end) {
+    const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+    end -= end % pageSize;
+    if (end > _released) {
+      ::madvise(const_cast<uint8_t*>(_data) + _released, end - _released,
+                MADV_DONTNEED);
+      _released = end;
+    }
+  }
+
+ private:
+  int _fd{-1};
+  const uint8_t* _data{nullptr};
+  size_t _size{0};
+  dev_t _device{0};
+  ino_t _inode{0};
+  size_t _released{0};
+  bool _valid{false};
+};
+
+/**
+ * @class OutputFile
+ * @brief Write-only file fed from a caller-owned buffer.
+ */
+class OutputFile {
+ public:
+  explicit OutputFile(const std::string& path) : _path(path) {
+    _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  }
+
+  ~OutputFile() {
+    if (_fd >= 0) {
+      ::close(_fd);
+    }
+  }
+
+  OutputFile(const OutputFile&) = delete;
+  OutputFile& operator=(const OutputFile&) = delete;
+
+  bool valid() const { return _fd >= 0; }
+  size_t written() const { return _written; }
+
+  /**
+   * @brief Writes all the bytes, retrying short and interrupted writes.
+   * @return false on I/O error, after printing it.
+   */
+  bool write(std::span<const uint8_t> bytes) {
+    while (!bytes.empty()) {
+      const ssize_t result = ::write(_fd, bytes.data(), bytes.size());
+      if (result < 0 && errno == EINTR) {
+        continue;
+      }
+      if (result < 0) {
+        std::cerr << "Cannot write " << _path << ": " << std::strerror(errno)
+                  << std::endl;
+        return false;
+      }
+      bytes = bytes.subspan(result);
+      _written += result;
+    }
+    return true;
+  }
+
+ private:
+  std::string _path;
+  int _fd{-1};
+  size_t _written{0};
+};
+
+/**
+ * @brief Encodes the raw values window by window.
+ * @return false on error, after printing it.
+ */
+bool compress(MappedFile& input, OutputFile& output) {
+  const auto bytes = input.bytes();
+  if (bytes.size() % sizeof(uint32_t) != 0) {
+    std::cerr << "Input size is not a multiple of 4 bytes" << std::endl;
+    return false;
+  }
+  const uint64_t count = bytes.size() / sizeof(uint32_t);
+  const auto* values = reinterpret_cast<const uint32_t*>(bytes.data());
+
+  std::vector<uint8_t> buffer(kWindowValues * kVlqMaxBytes<uint32_t>);
+  std::memcpy(buffer.data(), &count, kHeaderBytes);
+  if (!output.write({buffer.data(), kHeaderBytes})) {
+    return false;
+  }
+  for (size_t first = 0; first < count; first += kWindowValues) {
+    const size_t windowCount = std::min<size_t>(kWindowValues, count - first);
+    const size_t size =
+        vlqEncodeArray(values + first, windowCount, buffer.data());
+    if (!output.write({buffer.data(), size})) {
+      return false;
+    }
+    input.release((first + windowCount) * sizeof(uint32_t));
+  }
+  return true;
+}
+
+/**
+ * @brief Decodes the VLQ stream window by window.
+ *
+ * Each window is decoded with vlqDecodeArrayUntilEnd(), which runs the SIMD
+ * kernels and never reads past the bytes it is given, so truncated or
+ * corrupt files are reported instead of overrunning the mapping.
+ *
+ * @return false on error, after printing it.
+ */
+bool decompress(MappedFile& input, OutputFile& output) {
+  auto bytes = input.bytes();
+  if (bytes.size() < kHeaderBytes) {
+    std::cerr << "Input is too short for a VLQ file" << std::endl;
+    return false;
+  }
+  uint64_t count;
+  std::memcpy(&count, bytes.data(), kHeaderBytes);
+  bytes = bytes.subspan(kHeaderBytes);
+
+  std::vector<uint32_t> values(kWindowValues);
+  uint64_t decoded = 0;
+  while (decoded < count) {
+    const size_t windowCount =
+        std::min<uint64_t>(kWindowValues, count - decoded);
+    // Bounded to the window, so values are counted once, not on every pass.
+    const auto window = bytes.first(
+        std::min(bytes.size(), windowCount * kVlqMaxBytes<uint32_t>));
+    const auto result =
+        vlqDecodeArrayUntilEnd(window, std::span(values).first(windowCount));
+    if (result.decoded == 0) {
+      break;  // No complete value left
+    }
+    if (!output.write({reinterpret_cast<const uint8_t*>(values.data()),
+                       result.decoded * sizeof(uint32_t)})) {
+      return false;
+    }
+    bytes = bytes.subspan(result.consumed);
+    decoded += result.decoded;
+    input.release(input.bytes().size() - bytes.size());
+  }
+  if (decoded < count) {
+    std::cerr << "Truncated input: " << decoded << " of " << count
+              << " values" << std::endl;
+    return false;
+  }
+  if (!bytes.empty()) {
+    std::cerr << "Trailing bytes after " << count << " values" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::string mode = argc == 4 ? argv[1] : "";
+  if (mode != "compress" && mode != "decompress") {
+    std::cerr << "Usage: " << argv[0]
+              << " compress|decompress <input> <output>" << std::endl;
+    return 2;
+  }
+
+  MappedFile input(argv[2]);
+  if (!input.valid()) {
+    std::cerr << "Cannot map " << argv[2] << ": " << std::strerror(errno)
+              << std::endl;
+    return 1;
+  }
+  // Truncating the input would pull the pages from under its mapping.
+  if (input.isSameFile(argv[3])) {
+    std::cerr << "Input and output are the same file: " << argv[3]
+              << std::endl;
+    return 1;
+  }
+  OutputFile output(argv[3]);
+  if (!output.valid()) {
+    std::cerr << "Cannot open " << argv[3] << ": " << std::strerror(errno)
+              << std::endl;
+    return 1;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const bool ok = mode == "compress" ? compress(input, output)
+                                     : decompress(input, output);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (!ok) {
+    std::cerr << "Failed to " << mode << " " << argv[2] << std::endl;
+    return 1;
+  }
+
+  // Throughput is given in raw (uncompressed) bytes for both directions.
+  const size_t inputBytes = input.bytes().size();
+  const size_t rawBytes = mode == "compress" ? inputBytes : output.written();
+  const size_t vlqBytes = mode == "compress" ? output.written() : inputBytes;
+  std::cout << mode << ": " << rawBytes << " raw bytes, " << vlqBytes
+            << " VLQ bytes in " << elapsed.count() << " s" << std::endl;
+  std::cout << "throughput: " << rawBytes / 1e6 / elapsed.count() << " MB/s"
+            << std::endl;
+  std::cout << "ratio: "
+            << static_cast<double>(rawBytes) / std::max<size_t>(vlqBytes, 1)
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,192 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-frame.cc
+ * @brief Implementation of the checksummed VLQ frames.
+ *
+ * The CRC covers the payload followed by the header, so the encoder can
+ * checksum each window as soon as it is written and add the header, whose
+ * payload size is known only at the end, last.
+ */
+
+// standard includes
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define FRAME_HAVE_CRC32 1
+#endif
+
+// third-party includes
+
+// project includes
+#include "cpu-dispatch.h"
+#include "vlq-frame.h"
+#include "vlq.h"
+
+namespace {
+
+// Windows small enough for the encoded bytes to stay in L1 between the
+// codec and the CRC.
+constexpr size_t kWindowValues = 1024;
+constexpr size_t kWindowBytes = 4096;
+
+/**
+ * @brief Byte-at-a-time table of the reflected Castagnoli polynomial.
+ */
+constexpr std::array<uint32_t, 256> kCrcTable = [] {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (crc & 1 ? 0x82F63B78u : 0);
+    }
+    table[i] = crc;
+  }
+  return table;
+}();
+
+uint32_t crc32cScalar(const uint8_t* data, size_t size, uint32_t crc) {
+  crc = ~crc;
+  for (size_t i = 0; i < size; i++) {
+    crc = (crc >> 8) ^ kCrcTable[(crc ^ data[i]) & 0xFF];
+  }
+  return ~crc;
+}
+
+#ifdef FRAME_HAVE_CRC32
+/**
+ * @brief Checksums 8 bytes per crc32 instruction.
+ */
+__attribute__((target("sse4.2"))) uint32_t crc32cSse42(const uint8_t* data,
+                                                       size_t size,
+                                                       uint32_t crc) {
+  uint64_t state = ~crc;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(word));
+    state = _mm_crc32_u64(state, word);
+  }
+  for (; i < size; i++) {
+    state = _mm_crc32_u8(static_cast<uint32_t>(state), data[i]);
+  }
+  return ~static_cast<uint32_t>(state);
+}
+#endif  // FRAME_HAVE_CRC32
+
+void storeLe32(uint32_t value, uint8_t* out) {
+  for (size_t i = 0; i < sizeof(value); i++) {
+    out[i] = value >> (8 * i);
+  }
+}
+
+uint32_t loadLe32(const uint8_t* in) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < sizeof(value); i++) {
+    value |= uint32_t{in[i]} << (8 * i);
+  }
+  return value;
+}
+
+VlqFrameResult failure(VlqFrameStatus status) {
+  return VlqFrameResult{.status = status, .decoded = 0, .consumed = 0};
+}
+
+}  // namespace
+
+uint32_t crc32c(const uint8_t* data, size_t size, uint32_t crc) {
+  using Kernel = uint32_t (*)(const uint8_t*, size_t, uint32_t);
+#ifdef FRAME_HAVE_CRC32
+  // The SSE4.1 tier does not imply crc32, which came with SSE4.2.
+  static CpuKernel<Kernel> kernel(
+      {crc32cScalar,
+       cpuDetectedTier() >= CpuTier::kSse41 && __builtin_cpu_supports("sse4.2")
+           ? crc32cSse42
+           : nullptr,
+       nullptr, nullptr});
+#else
+  static CpuKernel<Kernel> kernel({crc32cScalar, nullptr, nullptr, nullptr});
+#endif
+  return kernel(data, size, crc);
+}
+
+size_t vlqFrameMaxSize(size_t count) {
+  return kVlqFrameHeaderBytes + count * kVlqMaxBytes<uint32_t> +
+         kVlqFrameTrailerBytes;
+}
+
+size_t vlqEncodeFrame(const uint32_t* values, size_t count, uint8_t* buffer) {
+  uint8_t* const payload = buffer + kVlqFrameHeaderBytes;
+  size_t payloadSize = 0;
+  uint32_t crc = 0;
+  for (size_t i = 0; i < count; i += kWindowValues) {
+    const size_t size = vlqEncodeArray(
+        values + i, std::min(kWindowValues, count - i), payload + payloadSize);
+    crc = crc32c(payload + payloadSize, size, crc);
+    payloadSize += size;
+  }
+  storeLe32(payloadSize, buffer);
+  storeLe32(count, buffer + sizeof(uint32_t));
+  crc = crc32c(buffer, kVlqFrameHeaderBytes, crc);
+  storeLe32(crc, payload + payloadSize);
+  return kVlqFrameHeaderBytes + payloadSize + kVlqFrameTrailerBytes;
+}
+
+size_t vlqFrameValueCount(std::span<const uint8_t> buffer) {
+  if (buffer.size() < kVlqFrameHeaderBytes) {
+    return 0;
+  }
+  return loadLe32(buffer.data() + sizeof(uint32_t));
+}
+
+VlqFrameResult vlqDecodeFrame(std::span<const uint8_t> buffer,
+                              std::span<uint32_t> values) {
+  if (buffer.size() < kVlqFrameHeaderBytes + kVlqFrameTrailerBytes) {
+    return failure(VlqFrameStatus::kTruncated);
+  }
+  const size_t payloadSize = loadLe32(buffer.data());
+  const size_t count = loadLe32(buffer.data() + sizeof(uint32_t));
+  if (buffer.size() - kVlqFrameHeaderBytes - kVlqFrameTrailerBytes <
+      payloadSize) {
+    return failure(VlqFrameStatus::kTruncated);
+  }
+  if (count > values.size()) {
+    return failure(VlqFrameStatus::kOutputTooSmall);
+  }
+
+  // Each window is decoded up to its last complete value, which never reads
+  // past the payload, and the bytes used go through the CRC.
+  const auto payload = buffer.subspan(kVlqFrameHeaderBytes, payloadSize);
+  size_t consumed = 0;
+  size_t decoded = 0;
+  uint32_t crc = 0;
+  while (consumed < payload.size()) {
+    const auto window = payload.subspan(
+        consumed, std::min(kWindowBytes, payload.size() - consumed));
+    const auto result = vlqDecodeArrayUntilEnd(
+        window, values.subspan(decoded, count - decoded));
+    if (result.consumed == 0) {
+      break;  // More values than the header says, or a cut last value
+    }
+    crc = crc32c(window.data(), result.consumed, crc);
+    consumed += result.consumed;
+    decoded += result.decoded;
+  }
+  crc = crc32c(buffer.data(), kVlqFrameHeaderBytes, crc);
+
+  if (consumed != payload.size() || decoded != count ||
+      crc != loadLe32(payload.data() + payload.size())) {
+    return failure(VlqFrameStatus::kCorrupt);
+  }
+  return VlqFrameResult{
+      .status = VlqFrameStatus::kOk,
+      .decoded = count,
+      .consumed =
+          kVlqFrameHeaderBytes + payloadSize + kVlqFrameTrailerBytes};
+}
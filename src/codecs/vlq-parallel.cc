@@ -0,0 +1,107 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-parallel.cc
+ * @brief Implementation of multi-threaded VLQ encoding and decoding.
+ */
+
+// standard includes
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// third-party includes
+
+// project includes
+#include "vlq-parallel.h"
+#include "vlq.h"
+
+namespace {
+
+/**
+ * @brief Runs func(task) for every task, on up to numThreads threads.
+ *
+ * Threads take the next task from a shared counter, so a slow chunk does not
+ * hold back the others. The calling thread is one of the workers.
+ */
+template <typename FUNC>
+void parallelFor(size_t numTasks, size_t numThreads, FUNC func) {
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  numThreads = std::min(numThreads, numTasks);
+
+  std::atomic<size_t> nextTask{0};
+  auto worker = [&]() {
+    for (size_t task; (task = nextTask.fetch_add(1)) < numTasks;) {
+      func(task);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < numThreads; i++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+size_t vlqEncodeArrayParallel(const uint32_t* values, size_t count,
+                              uint8_t* buffer, VlqChunkTable* table,
+                              size_t numThreads, size_t chunkValues) {
+  const size_t numChunks = (count + chunkValues - 1) / chunkValues;
+  auto chunkCount = [&](size_t chunk) {
+    return std::min(chunkValues, count - chunk * chunkValues);
+  };
+
+  // Reduce: exact size of every chunk.
+  std::vector<size_t> offsets(numChunks + 1, 0);
+  parallelFor(numChunks, numThreads, [&](size_t chunk) {
+    offsets[chunk + 1] = vlqEncodedSizeArray(values + chunk * chunkValues,
+                                             chunkCount(chunk));
+  });
+
+  // Scan: one entry per chunk, cheap next to the other two steps.
+  for (size_t chunk = 0; chunk < numChunks; chunk++) {
+    offsets[chunk + 1] += offsets[chunk];
+  }
+
+  // Encode every chunk at its offset. vlqEncodeArray() writes nothing past
+  // the chunk, so threads never touch each other's bytes.
+  parallelFor(numChunks, numThreads, [&](size_t chunk) {
+    vlqEncodeArray(values + chunk * chunkValues, chunkCount(chunk),
+                   buffer + offsets[chunk]);
+  });
+
+  const size_t totalSize = offsets.back();
+  if (table != nullptr) {
+    table->chunkValues = chunkValues;
+    table->count = count;
+    table->offsets = std::move(offsets);
+  }
+  return totalSize;
+}
+
+size_t vlqDecodeArrayParallel(const uint8_t* buffer, size_t count,
+                              uint32_t* values, const VlqChunkTable& table,
+                              size_t numThreads) {
+  // A table of another stream would make chunks start past the values.
+  if (table.offsets.empty() || table.chunkValues == 0 || table.count != count ||
+      table.offsets.size() - 1 !=
+          (count + table.chunkValues - 1) / table.chunkValues) {
+    return 0;
+  }
+  const size_t numChunks = table.offsets.size() - 1;
+  parallelFor(numChunks, numThreads, [&](size_t chunk) {
+    const size_t first = chunk * table.chunkValues;
+    vlqDecodeArray(buffer + table.offsets[chunk],
+                   std::min(table.chunkValues, count - first), values + first);
+  });
+  return table.offsets.back();
+}
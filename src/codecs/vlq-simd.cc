@@ -0,0 +1,885 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file vlq-simd.cc
+ * @brief SSE4.1/AVX2 batch decoder for VLQ and LEB128 encoded arrays.
+ *
+ * The decoder loads 16 bytes at a time and takes the movemask of the
+ * continuation bits. The low 12 bits of that mask select an entry of a lookup
+ * table which tells:
+ *  - how many values can be decoded from those bytes,
+ *  - how many bytes they use,
+ *  - which shuffle moves their bytes into 16-bit or 32-bit lanes.
+ *
+ * Since VLQ stores the most significant group first, the shuffle also reverses
+ * the bytes of each value, so the terminator byte (lowest 7 bits) lands in the
+ * lowest byte of its lane:
+ *
+ *     bytes:   [0x81 0x00] [0x7F] [0x85 0x80 0x01]
+ *     lanes:   | 00 81 | 7F .. | 01 80 85 .. |
+ *
+ * LEB128 already stores the lowest group first, so its shuffle keeps the
+ * bytes in order. The continuation masks are the same for both formats, and
+ * so is everything after the shuffle: each format has its own tables and
+ * the kernels take the order as a template parameter.
+ *
+ * The 7-bit groups of every lane are then merged with shifts and masks and
+ * widened to the output type (uint16_t, uint32_t or uint64_t). Values longer
+ * than 4 bytes are decoded one at a time from a 64-bit load.
+ *
+ * Each decode step hands its values, still in registers, to a sink. The
+ * array decoder stores them; the fused kernels of vlq-aggregate.h fold them
+ * into a sum, a minimum/maximum or a count instead, and never write them to
+ * memory.
+ *
+ * The vectorized computation of the encoded size of arrays, and the counting
+ * of the values of a buffer, live here too.
+ *
+ * Every entry point runs the kernel of the tier chosen by cpu-dispatch.h.
+ */
+
+
+// standard includes
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define VLQ_HAVE_X86 1
+#endif
+
+// third-party includes
+
+// project includes
+#include "cpu-dispatch.h"
+#include "vlq-aggregate.h"
+#include "vlq.h"
+
+namespace {
+
+/**
+ * @brief Decodes values one at a time, used for the last few values.
+ */
+template <VlqOrder ORDER, VlqInteger T>
+size_t decodeScalar(const uint8_t* buffer, size_t count, T* values) {
+  size_t totalSize = 0;
+  for (size_t i = 0; i < count; i++) {
+    totalSize += vlqDecodeValue<T, ORDER>(buffer + totalSize, &values[i]);
+  }
+  return totalSize;
+}
+
+/**
+ * @brief Feeds values to a sink one at a time.
+ */
+template <VlqOrder ORDER, typename SINK>
+inline size_t decodeTail(const uint8_t* in, size_t count, SINK& sink) {
+  using Value = typename SINK::Value;
+  size_t size = 0;
+  for (size_t i = 0; i < count; i++) {
+    Value value;
+    size += vlqDecodeValue<Value, ORDER>(in + size, &value);
+    sink.value(value);
+  }
+  return size;
+}
+
+/**
+ * @brief Scalar part of the sum: values decoded one at a time.
+ */
+struct SumScalarSink {
+  using Value = uint32_t;
+
+  uint64_t _sum{0};
+
+  void value(uint32_t decoded) { _sum += decoded; }
+  uint64_t result() const { return _sum; }
+};
+
+/**
+ * @brief Scalar part of the minimum and maximum.
+ */
+struct MinMaxScalarSink {
+  using Value = uint32_t;
+
+  uint32_t _min{UINT32_MAX};
+  uint32_t _max{0};
+
+  void value(uint32_t decoded) {
+    _min = std::min(_min, decoded);
+    _max = std::max(_max, decoded);
+  }
+};
+
+/**
+ * @brief Scalar part of the count of values in [low, low + span].
+ */
+struct CountInRangeScalarSink {
+  using Value = uint32_t;
+
+  uint32_t _low;
+  uint32_t _span;
+  size_t _count{0};
+
+  void value(uint32_t decoded) { _count += decoded - _low <= _span; }
+};
+
+}  // namespace
+
+#ifdef VLQ_HAVE_X86
+namespace {
+
+// Number of bytes covered by the continuation mask used as table index.
+constexpr int kMaskBits = 12;
+
+struct DecodeEntry {
+  uint8_t shuffle;   ///< Index in the shuffle table.
+  uint8_t consumed;  ///< Bytes used by the decoded values.
+  uint8_t count;     ///< Values decoded. 0 means use the scalar decoder.
+  uint8_t wide;      ///< 0: values are merged in 16-bit lanes, 1: in 32-bit.
+};
+
+struct DecodeTables {
+  std::array<DecodeEntry, 1 << kMaskBits> entries{};
+  std::array<std::array<uint8_t, 16>, 256> shuffles{};
+  size_t numShuffles{0};
+};
+
+/**
+ * @brief Builds the lookup tables for every 12-bit continuation mask.
+ *
+ * Values of up to 2 bytes are merged in 16-bit lanes (up to 6 per step),
+ * values of 3 or 4 bytes in 32-bit lanes (up to 3 per step).
+ */
+DecodeTables buildTables(VlqOrder order) {
+  DecodeTables tables;
+  for (uint32_t mask = 0; mask < (1u << kMaskBits); mask++) {
+    // Lengths of the complete values found in the first 12 bytes.
+    uint8_t lengths[kMaskBits];
+    int numValues = 0;
+    int start = 0;
+    for (int i = 0; i < kMaskBits; i++) {
+      if (!(mask & (1u << i))) {
+        lengths[numValues++] = i - start + 1;
+        start = i + 1;
+      }
+    }
+
+    DecodeEntry& entry = tables.entries[mask];
+    if (numValues == 0 || lengths[0] > 4) {
+      continue;  // count = 0, scalar fallback
+    }
+    const bool wide = lengths[0] > 2;
+    const int maxLength = wide ? 4 : 2;
+    const int laneSize = wide ? 4 : 2;
+    const int maxValues = wide ? 3 : 6;
+
+    std::array<uint8_t, 16> shuffle;
+    shuffle.fill(0x80);  // pshufb writes zero for indexes with MSB set
+    int count = 0;
+    int offset = 0;
+    while (count < numValues && count < maxValues &&
+           lengths[count] <= maxLength) {
+      const int length = lengths[count];
+      for (int j = 0; j < length; j++) {
+        shuffle[count * laneSize + j] = order == VlqOrder::kMsbFirst
+                                             ? offset + length - 1 - j
+                                             : offset + j;
+      }
+      offset += length;
+      count++;
+    }
+
+    size_t index = 0;
+    while (index < tables.numShuffles && tables.shuffles[index] != shuffle) {
+      index++;
+    }
+    if (index == tables.numShuffles) {
+      tables.shuffles[tables.numShuffles++] = shuffle;
+    }
+    entry.shuffle = index;
+    entry.consumed = offset;
+    entry.count = count;
+    entry.wide = wide;
+  }
+  return tables;
+}
+
+template <VlqOrder ORDER>
+const DecodeTables& decodeTables() {
+  static const DecodeTables tables = buildTables(ORDER);
+  return tables;
+}
+
+/**
+ * @brief Decodes a value of up to 8 bytes from a single 64-bit load.
+ *
+ * The value bytes are moved so that the lowest group is the lowest byte (VLQ
+ * byte-swaps them, LEB128 only masks off the bytes past the value), then the
+ * 7-bit groups are packed in three steps (16, 32, 64-bit lanes). Longer
+ * values go through the byte loop. Needs 8 readable bytes.
+ */
+template <VlqOrder ORDER, VlqInteger T>
+__attribute__((always_inline)) inline size_t decodeWord(const uint8_t* in,
+                                                       T* out) {
+  uint64_t word;
+  std::memcpy(&word, in, sizeof(word));
+  const uint64_t stops = ~word & 0x8080808080808080ull;
+  if (stops == 0) {
+    return vlqDecodeValue<T, ORDER>(in, out);
+  }
+  const int size = std::countr_zero(stops) / 8 + 1;
+  uint64_t groups = ORDER == VlqOrder::kMsbFirst
+                        ? __builtin_bswap64(word) >> (64 - 8 * size)
+                        : word & (~0ull >> (64 - 8 * size));
+  groups &= 0x7F7F7F7F7F7F7F7Full;
+  groups = (groups & 0x007F007F007F007Full) |
+           ((groups & 0x7F007F007F007F00ull) >> 1);
+  groups = (groups & 0x00003FFF00003FFFull) |
+           ((groups & 0x3FFF00003FFF0000ull) >> 2);
+  groups = (groups & 0x000000000FFFFFFFull) |
+           ((groups & 0x0FFFFFFF00000000ull) >> 4);
+  *out = static_cast<T>(groups);
+  return size;
+}
+
+/**
+ * @brief Widens 16 single-byte values to T and stores them.
+ */
+template <VlqInteger T>
+__attribute__((target("sse4.1"), always_inline)) inline void storeBytes(
+    __m128i data, T* out) {
+  auto* dst = reinterpret_cast<__m128i*>(out);
+  if constexpr (sizeof(T) == 2) {
+    _mm_storeu_si128(dst, _mm_cvtepu8_epi16(data));
+    _mm_storeu_si128(dst + 1, _mm_cvtepu8_epi16(_mm_srli_si128(data, 8)));
+  } else if constexpr (sizeof(T) == 4) {
+    _mm_storeu_si128(dst, _mm_cvtepu8_epi32(data));
+    _mm_storeu_si128(dst + 1, _mm_cvtepu8_epi32(_mm_srli_si128(data, 4)));
+    _mm_storeu_si128(dst + 2, _mm_cvtepu8_epi32(_mm_srli_si128(data, 8)));
+    _mm_storeu_si128(dst + 3, _mm_cvtepu8_epi32(_mm_srli_si128(data, 12)));
+  } else {
+    _mm_storeu_si128(dst, _mm_cvtepu8_epi64(data));
+    _mm_storeu_si128(dst + 1, _mm_cvtepu8_epi64(_mm_srli_si128(data, 2)));
+    _mm_storeu_si128(dst + 2, _mm_cvtepu8_epi64(_mm_srli_si128(data, 4)));
+    _mm_storeu_si128(dst + 3, _mm_cvtepu8_epi64(_mm_srli_si128(data, 6)));
+    _mm_storeu_si128(dst + 4, _mm_cvtepu8_epi64(_mm_srli_si128(data, 8)));
+    _mm_storeu_si128(dst + 5, _mm_cvtepu8_epi64(_mm_srli_si128(data, 10)));
+    _mm_storeu_si128(dst + 6, _mm_cvtepu8_epi64(_mm_srli_si128(data, 12)));
+    _mm_storeu_si128(dst + 7, _mm_cvtepu8_epi64(_mm_srli_si128(data, 14)));
+  }
+}
+
+/**
+ * @brief Widens 8 values held in 16-bit lanes to T and stores them.
+ */
+template <VlqInteger T>
+__attribute__((target("sse4.1"), always_inline)) inline void storeLanes16(
+    __m128i lanes, T* out) {
+  auto* dst = reinterpret_cast<__m128i*>(out);
+  if constexpr (sizeof(T) == 2) {
+    _mm_storeu_si128(dst, lanes);
+  } else if constexpr (sizeof(T) == 4) {
+    _mm_storeu_si128(dst, _mm_cvtepu16_epi32(lanes));
+    _mm_storeu_si128(dst + 1, _mm_cvtepu16_epi32(_mm_srli_si128(lanes, 8)));
+  } else {
+    _mm_storeu_si128(dst, _mm_cvtepu16_epi64(lanes));
+    _mm_storeu_si128(dst + 1, _mm_cvtepu16_epi64(_mm_srli_si128(lanes, 4)));
+    _mm_storeu_si128(dst + 2, _mm_cvtepu16_epi64(_mm_srli_si128(lanes, 8)));
+    _mm_storeu_si128(dst + 3, _mm_cvtepu16_epi64(_mm_srli_si128(lanes, 12)));
+  }
+}
+
+/**
+ * @brief Converts 4 values held in 32-bit lanes to T and stores them.
+ *
+ * For uint16_t only the low half of each lane is kept, which wraps the
+ * value exactly like the scalar decoder does.
+ */
+template <VlqInteger T>
+__attribute__((target("sse4.1"), always_inline)) inline void storeLanes32(
+    __m128i lanes, T* out) {
+  auto* dst = reinterpret_cast<__m128i*>(out);
+  if constexpr (sizeof(T) == 2) {
+    const __m128i lowHalves =
+        _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    _mm_storel_epi64(dst, _mm_shuffle_epi8(lanes, lowHalves));
+  } else if constexpr (sizeof(T) == 4) {
+    _mm_storeu_si128(dst, lanes);
+  } else {
+    _mm_storeu_si128(dst, _mm_cvtepu32_epi64(lanes));
+    _mm_storeu_si128(dst + 1, _mm_cvtepu32_epi64(_mm_srli_si128(lanes, 8)));
+  }
+}
+
+/**
+ * @brief Sink that stores the decoded values to an array.
+ *
+ * A sink receives the values of a decode step while they are still in
+ * registers:
+ *  - bytes(): 16 values of one byte each,
+ *  - lanes16() / lanes32(): the first n lanes hold values, the others are 0,
+ *  - value(): a single value decoded by decodeWord().
+ */
+template <VlqInteger T>
+struct StoreSink {
+  using Value = T;
+
+  T* out;
+
+  __attribute__((target("sse4.1"), always_inline)) void bytes(__m128i data) {
+    storeBytes(data, out);
+    out += 16;
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes16(__m128i lanes,
+                                                                size_t n) {
+    storeLanes16(lanes, out);
+    out += n;
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes32(__m128i lanes,
+                                                                size_t n) {
+    storeLanes32(lanes, out);
+    out += n;
+  }
+  void value(T decoded) { *out++ = decoded; }
+};
+
+/**
+ * @brief Decodes one step from 16 readable bytes into a sink.
+ *
+ * A StoreSink may write up to 16 values, so the caller must have room for
+ * them.
+ *
+ * @param in Input pointer, advanced by the consumed bytes.
+ * @return The number of values decoded (1 to 16).
+ */
+template <VlqOrder ORDER, typename SINK>
+__attribute__((target("sse4.1"), always_inline)) inline size_t decodeStep(
+    const DecodeTables& tables, const uint8_t*& in, SINK& sink) {
+  const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const uint32_t mask = _mm_movemask_epi8(data);
+
+  if (mask == 0) {
+    // 16 values of one byte each
+    sink.bytes(data);
+    in += 16;
+    return 16;
+  }
+
+  const DecodeEntry entry = tables.entries[mask & ((1u << kMaskBits) - 1)];
+  if (entry.count == 0) {
+    typename SINK::Value value;
+    in += decodeWord<ORDER>(in, &value);
+    sink.value(value);
+    return 1;
+  }
+
+  const __m128i shuffle = _mm_loadu_si128(
+      reinterpret_cast<const __m128i*>(tables.shuffles[entry.shuffle].data()));
+  const __m128i lanes =
+      _mm_and_si128(_mm_shuffle_epi8(data, shuffle), _mm_set1_epi8(0x7F));
+
+  if (!entry.wide) {
+    // lane = 0hhhhhhh 0lllllll -> 00hhhhhh hlllllll
+    const __m128i merged = _mm_or_si128(
+        _mm_and_si128(lanes, _mm_set1_epi16(0x007F)),
+        _mm_srli_epi16(_mm_and_si128(lanes, _mm_set1_epi16(0x7F00)), 1));
+    sink.lanes16(merged, entry.count);
+  } else {
+    __m128i merged = _mm_and_si128(lanes, _mm_set1_epi32(0x0000007F));
+    merged = _mm_or_si128(merged, _mm_and_si128(_mm_srli_epi32(lanes, 1),
+                                                _mm_set1_epi32(0x3F80)));
+    merged = _mm_or_si128(merged, _mm_and_si128(_mm_srli_epi32(lanes, 2),
+                                                _mm_set1_epi32(0x1FC000)));
+    merged = _mm_or_si128(merged, _mm_and_si128(_mm_srli_epi32(lanes, 3),
+                                                _mm_set1_epi32(0x0FE00000)));
+    sink.lanes32(merged, entry.count);
+  }
+  in += entry.consumed;
+  return entry.count;
+}
+
+// Every value takes at least one byte, so while 16 values are still expected
+// at least 16 bytes can be loaded and 16 values can be written.
+constexpr size_t kStepValues = 16;
+
+// The kernels work on a local copy of the sink, which the compiler can keep
+// in registers: stores through __m128i may alias anything, the caller's sink
+// included.
+
+template <VlqOrder ORDER, typename SINK>
+__attribute__((target("sse4.1"))) size_t decodeSse41(const uint8_t* buffer,
+                                                     size_t count,
+                                                     SINK& result) {
+  const DecodeTables& tables = decodeTables<ORDER>();
+  SINK sink = result;
+  const uint8_t* in = buffer;
+  while (count >= kStepValues) {
+    count -= decodeStep<ORDER>(tables, in, sink);
+  }
+  in += decodeTail<ORDER>(in, count, sink);
+  result = sink;
+  return in - buffer;
+}
+
+template <VlqOrder ORDER, typename SINK>
+__attribute__((target("avx2"))) size_t decodeAvx2(const uint8_t* buffer,
+                                                  size_t count,
+                                                  SINK& result) {
+  const DecodeTables& tables = decodeTables<ORDER>();
+  SINK sink = result;
+  const uint8_t* in = buffer;
+  while (count >= 2 * kStepValues) {
+    const __m256i data =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    if (_mm256_movemask_epi8(data) == 0) {
+      // 32 values of one byte each
+      sink.bytes(_mm256_castsi256_si128(data));
+      sink.bytes(_mm256_extracti128_si256(data, 1));
+      in += 32;
+      count -= 32;
+    } else {
+      count -= decodeStep<ORDER>(tables, in, sink);
+    }
+  }
+  while (count >= kStepValues) {
+    count -= decodeStep<ORDER>(tables, in, sink);
+  }
+  in += decodeTail<ORDER>(in, count, sink);
+  result = sink;
+  return in - buffer;
+}
+
+/**
+ * @brief Mask of the first n 32-bit lanes.
+ */
+__attribute__((target("sse4.1"), always_inline)) inline __m128i firstLanes32(
+    int n) {
+  return _mm_cmpgt_epi32(_mm_set1_epi32(n), _mm_setr_epi32(0, 1, 2, 3));
+}
+
+/**
+ * @brief Sums the lanes into two 64-bit accumulators.
+ *
+ * The unused lanes of a step are 0, so they can be added as they are.
+ */
+struct SumSink : SumScalarSink {
+  __m128i _lanes = _mm_setzero_si128();
+
+  __attribute__((target("sse4.1"), always_inline)) void bytes(__m128i data) {
+    _lanes = _mm_add_epi64(_lanes, _mm_sad_epu8(data, _mm_setzero_si128()));
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes16(__m128i lanes,
+                                                                size_t) {
+    // 16-bit lanes hold at most 14 bits, the pairwise sums fit easily.
+    add32(_mm_madd_epi16(lanes, _mm_set1_epi16(1)));
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes32(__m128i lanes,
+                                                                size_t) {
+    add32(lanes);
+  }
+  __attribute__((target("sse4.1"), always_inline)) void add32(__m128i lanes) {
+    const __m128i zero = _mm_setzero_si128();
+    _lanes = _mm_add_epi64(_lanes,
+                           _mm_add_epi64(_mm_unpacklo_epi32(lanes, zero),
+                                         _mm_unpackhi_epi32(lanes, zero)));
+  }
+  uint64_t result() const {
+    uint64_t sums[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), _lanes);
+    return _sum + sums[0] + sums[1];
+  }
+};
+
+/**
+ * @brief Keeps the minimum and maximum of every lane width apart, so the
+ * values never need widening.
+ *
+ * The unused lanes of a step are 0: harmless for the maximum, replaced by
+ * all ones for the minimum.
+ */
+struct MinMaxSink : MinMaxScalarSink {
+  __m128i _min8 = _mm_set1_epi8(-1);
+  __m128i _max8 = _mm_setzero_si128();
+  __m128i _min16 = _mm_set1_epi16(-1);
+  __m128i _max16 = _mm_setzero_si128();
+  __m128i _min32 = _mm_set1_epi32(-1);
+  __m128i _max32 = _mm_setzero_si128();
+
+  __attribute__((target("sse4.1"), always_inline)) void bytes(__m128i data) {
+    _min8 = _mm_min_epu8(_min8, data);
+    _max8 = _mm_max_epu8(_max8, data);
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes16(__m128i lanes,
+                                                                size_t n) {
+    const __m128i unused = _mm_cmpgt_epi16(
+        _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7), _mm_set1_epi16(n - 1));
+    _min16 = _mm_min_epu16(_min16, _mm_or_si128(lanes, unused));
+    _max16 = _mm_max_epu16(_max16, lanes);
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes32(__m128i lanes,
+                                                                size_t n) {
+    const __m128i unused =
+        _mm_cmpgt_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(n - 1));
+    _min32 = _mm_min_epu32(_min32, _mm_or_si128(lanes, unused));
+    _max32 = _mm_max_epu32(_max32, lanes);
+  }
+  VlqMinMaxResult result() const {
+    uint8_t min8[16], max8[16];
+    uint16_t min16[8], max16[8];
+    uint32_t min32[4], max32[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(min8), _min8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(max8), _max8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(min16), _min16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(max16), _max16);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(min32), _min32);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(max32), _max32);
+    // All ones is never a value of these widths (at most 7 and 14 bits),
+    // only the start value of a lane that got none.
+    uint32_t min = _min;
+    uint32_t max = _max;
+    for (size_t i = 0; i < 16; i++) {
+      min = std::min(min, min8[i] == UINT8_MAX ? UINT32_MAX : min8[i]);
+      max = std::max<uint32_t>(max, max8[i]);
+    }
+    for (size_t i = 0; i < 8; i++) {
+      min = std::min(min, min16[i] == UINT16_MAX ? UINT32_MAX : min16[i]);
+      max = std::max<uint32_t>(max, max16[i]);
+    }
+    for (size_t i = 0; i < 4; i++) {
+      min = std::min(min, min32[i]);
+      max = std::max(max, max32[i]);
+    }
+    return {min, max, 0};
+  }
+};
+
+/**
+ * @brief Counts the lanes in [low, low + span] with one unsigned compare:
+ * value - low <= span, i.e. min(value - low, span) == value - low.
+ */
+struct CountInRangeSink : CountInRangeScalarSink {
+  __attribute__((target("sse4.1"), always_inline)) void bytes(__m128i data) {
+    const __m128i all = _mm_set1_epi32(-1);
+    count32(_mm_cvtepu8_epi32(data), all);
+    count32(_mm_cvtepu8_epi32(_mm_srli_si128(data, 4)), all);
+    count32(_mm_cvtepu8_epi32(_mm_srli_si128(data, 8)), all);
+    count32(_mm_cvtepu8_epi32(_mm_srli_si128(data, 12)), all);
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes16(__m128i lanes,
+                                                                size_t n) {
+    count32(_mm_cvtepu16_epi32(lanes), firstLanes32(n));
+    if (n > 4) {
+      count32(_mm_cvtepu16_epi32(_mm_srli_si128(lanes, 8)),
+              firstLanes32(n - 4));
+    }
+  }
+  __attribute__((target("sse4.1"), always_inline)) void lanes32(__m128i lanes,
+                                                                size_t n) {
+    count32(lanes, firstLanes32(n));
+  }
+  __attribute__((target("sse4.1"), always_inline)) void count32(
+      __m128i lanes, __m128i used) {
+    const __m128i offset = _mm_sub_epi32(lanes, _mm_set1_epi32(_low));
+    const __m128i inside = _mm_cmpeq_epi32(
+        _mm_min_epu32(offset, _mm_set1_epi32(_span)), offset);
+    _count += std::popcount(static_cast<uint32_t>(
+        _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(inside, used)))));
+  }
+};
+
+}  // namespace
+#endif  // VLQ_HAVE_X86
+
+namespace {
+
+#ifdef VLQ_HAVE_X86
+template <VlqOrder ORDER, VlqInteger T>
+__attribute__((target("sse4.1"))) size_t decodeArraySse41(
+    const uint8_t* buffer, size_t count, T* values) {
+  StoreSink<T> sink{values};
+  return decodeSse41<ORDER>(buffer, count, sink);
+}
+
+template <VlqOrder ORDER, VlqInteger T>
+__attribute__((target("avx2"))) size_t decodeArrayAvx2(const uint8_t* buffer,
+                                                       size_t count,
+                                                       T* values) {
+  StoreSink<T> sink{values};
+  return decodeAvx2<ORDER>(buffer, count, sink);
+}
+#endif  // VLQ_HAVE_X86
+
+template <VlqOrder ORDER, VlqInteger T>
+size_t decodeBest(const uint8_t* buffer, size_t count, T* values) {
+  using Kernel = size_t (*)(const uint8_t*, size_t, T*);
+#ifdef VLQ_HAVE_X86
+  static CpuKernel<Kernel> kernel({decodeScalar<ORDER, T>,
+                                   decodeArraySse41<ORDER, T>,
+                                   decodeArrayAvx2<ORDER, T>, nullptr});
+#else
+  static CpuKernel<Kernel> kernel(
+      {decodeScalar<ORDER, T>, nullptr, nullptr, nullptr});
+#endif
+  return kernel(buffer, count, values);
+}
+
+/**
+ * @brief Runs the best decoder available into an aggregating sink.
+ */
+template <typename SINK>
+size_t aggregateBest(const uint8_t* buffer, size_t count, SINK& sink) {
+  using Kernel = size_t (*)(const uint8_t*, size_t, SINK&);
+  constexpr VlqOrder kOrder = VlqOrder::kMsbFirst;
+#ifdef VLQ_HAVE_X86
+  static CpuKernel<Kernel> kernel({decodeTail<kOrder, SINK>,
+                                   decodeSse41<kOrder, SINK>,
+                                   decodeAvx2<kOrder, SINK>, nullptr});
+#else
+  static CpuKernel<Kernel> kernel(
+      {decodeTail<kOrder, SINK>, nullptr, nullptr, nullptr});
+#endif
+  return kernel(buffer, count, sink);
+}
+
+template <VlqInteger T>
+size_t encodedSizeScalar(const T* values, size_t count) {
+  size_t totalSize = 0;
+  for (size_t i = 0; i < count; i++) {
+    totalSize += vlqEncodedSize(values[i]);
+  }
+  return totalSize;
+}
+
+#ifdef VLQ_HAVE_X86
+/**
+ * @brief Sums the VLQ sizes of an array with SSE4.1.
+ *
+ * Each lane starts at kVlqMaxBytes<T>. A compare against zero yields -1 per
+ * 7-bit shift that leaves the lane empty, and those are accumulated.
+ */
+template <VlqInteger T>
+__attribute__((target("sse4.1"))) size_t encodedSizeSse41(const T* values,
+                                                          size_t count) {
+  constexpr size_t kLanes = sizeof(__m128i) / sizeof(T);
+  // A lane goes down by at most kVlqMaxBytes<T> per step, flush it to the
+  // total long before a 32-bit lane could overflow.
+  constexpr size_t kFlushSteps = 1 << 24;
+  using Lane = std::conditional_t<sizeof(T) == 8, int64_t, int32_t>;
+
+  int64_t totalSize = 0;
+  size_t i = 0;
+  while (i + kLanes <= count) {
+    const size_t steps = std::min((count - i) / kLanes, kFlushSteps);
+    __m128i empty = _mm_setzero_si128();
+    for (size_t step = 0; step < steps; step++, i += kLanes) {
+      __m128i lanes =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+      for (size_t k = 1; k < kVlqMaxBytes<T>; k++) {
+        if constexpr (sizeof(T) == 8) {
+          lanes = _mm_srli_epi64(lanes, 7);
+          empty = _mm_add_epi64(
+              empty, _mm_cmpeq_epi64(lanes, _mm_setzero_si128()));
+        } else {
+          lanes = _mm_srli_epi32(lanes, 7);
+          empty = _mm_add_epi32(
+              empty, _mm_cmpeq_epi32(lanes, _mm_setzero_si128()));
+        }
+      }
+    }
+    Lane sums[kLanes];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), empty);
+    totalSize += static_cast<int64_t>(steps * kLanes * kVlqMaxBytes<T>);
+    for (Lane sum : sums) {
+      totalSize += sum;
+    }
+  }
+  return totalSize + encodedSizeScalar(values + i, count - i);
+}
+#endif  // VLQ_HAVE_X86
+
+template <VlqInteger T>
+size_t encodedSizeBest(const T* values, size_t count) {
+  using Kernel = size_t (*)(const T*, size_t);
+#ifdef VLQ_HAVE_X86
+  static CpuKernel<Kernel> kernel(
+      {encodedSizeScalar<T>, encodedSizeSse41<T>, nullptr, nullptr});
+#else
+  static CpuKernel<Kernel> kernel(
+      {encodedSizeScalar<T>, nullptr, nullptr, nullptr});
+#endif
+  return kernel(values, count);
+}
+
+/**
+ * @brief Counts the terminator bytes 8 at a time in a 64-bit word.
+ */
+size_t countValuesScalar(const uint8_t* buffer, size_t size) {
+  size_t count = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, buffer + i, sizeof(word));
+    count += std::popcount(~word & 0x8080808080808080ull);
+  }
+  for (; i < size; i++) {
+    count += !(buffer[i] & 0x80);
+  }
+  return count;
+}
+
+#ifdef VLQ_HAVE_X86
+/**
+ * @brief Counts the terminator bytes 16 at a time from the movemask.
+ */
+__attribute__((target("sse4.1"))) size_t countValuesSse41(
+    const uint8_t* buffer, size_t size) {
+  size_t continued = 0;
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i data =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+    continued +=
+        std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(data)));
+  }
+  return i - continued + countValuesScalar(buffer + i, size - i);
+}
+
+/**
+ * @brief Counts the terminator bytes 64 at a time, from two 32-bit masks
+ * joined into one 64-bit popcount.
+ */
+__attribute__((target("avx2,popcnt"))) size_t countValuesAvx2(
+    const uint8_t* buffer, size_t size) {
+  size_t continued = 0;
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    const __m256i low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i));
+    const __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer + i + 32));
+    const uint64_t mask =
+        static_cast<uint32_t>(_mm256_movemask_epi8(low)) |
+        static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(high)))
+            << 32;
+    continued += std::popcount(mask);
+  }
+  return i - continued + countValuesSse41(buffer + i, size - i);
+}
+
+/**
+ * @brief Counts the terminator bytes 64 at a time; the tail is read with a
+ * masked load, which never touches the bytes past the end.
+ */
+__attribute__((target("avx512f,avx512bw,popcnt"))) size_t countValuesAvx512(
+    const uint8_t* buffer, size_t size) {
+  size_t continued = 0;
+  size_t i = 0;
+  for (; i + 64 <= size; i += 64) {
+    const uint64_t mask = _mm512_movepi8_mask(_mm512_loadu_si512(buffer + i));
+    continued += std::popcount(mask);
+  }
+  if (i < size) {
+    const __mmask64 used = ~0ull >> (64 - (size - i));
+    continued += std::popcount(static_cast<uint64_t>(
+        _mm512_movepi8_mask(_mm512_maskz_loadu_epi8(used, buffer + i))));
+  }
+  return size - continued;
+}
+#endif  // VLQ_HAVE_X86
+
+}  // namespace
+
+size_t vlqDecodeArraySimd(const uint8_t* buffer, size_t count,
+                          uint16_t* values) {
+  return decodeBest<VlqOrder::kMsbFirst>(buffer, count, values);
+}
+
+size_t vlqDecodeArraySimd(const uint8_t* buffer, size_t count,
+                          uint32_t* values) {
+  return decodeBest<VlqOrder::kMsbFirst>(buffer, count, values);
+}
+
+size_t vlqDecodeArraySimd(const uint8_t* buffer, size_t count,
+                          uint64_t* values) {
+  return decodeBest<VlqOrder::kMsbFirst>(buffer, count, values);
+}
+
+size_t leb128DecodeArraySimd(const uint8_t* buffer, size_t count,
+                             uint16_t* values) {
+  return decodeBest<VlqOrder::kLsbFirst>(buffer, count, values);
+}
+
+size_t leb128DecodeArraySimd(const uint8_t* buffer, size_t count,
+                             uint32_t* values) {
+  return decodeBest<VlqOrder::kLsbFirst>(buffer, count, values);
+}
+
+size_t leb128DecodeArraySimd(const uint8_t* buffer, size_t count,
+                             uint64_t* values) {
+  return decodeBest<VlqOrder::kLsbFirst>(buffer, count, values);
+}
+
+size_t vlqEncodedSizeArray(const uint32_t* values, size_t count) {
+  return encodedSizeBest(values, count);
+}
+
+size_t vlqEncodedSizeArray(const uint64_t* values, size_t count) {
+  return encodedSizeBest(values, count);
+}
+
+size_t vlqCountValues(const uint8_t* buffer, size_t size) {
+  using Kernel = size_t (*)(const uint8_t*, size_t);
+#ifdef VLQ_HAVE_X86
+  static CpuKernel<Kernel> kernel({countValuesScalar, countValuesSse41,
+                                   countValuesAvx2, countValuesAvx512});
+#else
+  static CpuKernel<Kernel> kernel(
+      {countValuesScalar, nullptr, nullptr, nullptr});
+#endif
+  return kernel(buffer, size);
+}
+
+VlqSumResult vlqSumArray(const uint8_t* buffer, size_t count) {
+#ifdef VLQ_HAVE_X86
+  SumSink sink;
+#else
+  SumScalarSink sink;
+#endif
+  const size_t consumed = aggregateBest(buffer, count, sink);
+  return {sink.result(), consumed};
+}
+
+VlqMinMaxResult vlqMinMaxArray(const uint8_t* buffer, size_t count) {
+#ifdef VLQ_HAVE_X86
+  MinMaxSink sink;
+  const size_t consumed = aggregateBest(buffer, count, sink);
+  VlqMinMaxResult result = sink.result();
+  result.consumed = consumed;
+  return result;
+#else
+  MinMaxScalarSink sink;
+  const size_t consumed = aggregateBest(buffer, count, sink);
+  return {sink._min, sink._max, consumed};
+#endif
+}
+
+VlqCountResult vlqCountInRangeArray(const uint8_t* buffer, size_t count,
+                                    uint32_t low, uint32_t high) {
+#ifdef VLQ_HAVE_X86
+  CountInRangeSink sink;
+#else
+  CountInRangeScalarSink sink;
+#endif
+  sink._low = low;
+  sink._span = high - low;
+  const size_t consumed = aggregateBest(buffer, count, sink);
+  return {sink._count, consumed};
+}
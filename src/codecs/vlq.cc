@@ -17,53 +17,135 @@
 #include "vlq.h"
 
 size_t vlqEncode(uint32_t value, uint8_t* buffer) {
-  size_t size = 0;
-  uint8_t temp[5];
-
-  do {
-    temp[size] = (value & 0x7F);
-    if (size > 0) {
-      temp[size] |= 0x80;
-    }
-    value >>= 7;
-    size++;
-  } while (value > 0);
-
-  // Reverse and copy to buffer
-  for (size_t i = 0; i < size; i++) {
-    buffer[i] = temp[size - i - 1];
-  }
-
-  return size;
+  return vlqEncodeValue(value, buffer);
 }
 
 size_t vlqDecode(const uint8_t* buffer, uint32_t* value) {
-  *value = 0;
-  size_t size = 0;
-
-  for (;;) {
-    *value = (*value << 7) | (buffer[size] & 0x7F);
-    if (!(buffer[size] & 0x80)) {
-      break;
-    }
-    size++;
-  }
-
-  return size + 1;
+  return vlqDecodeValue(buffer, value);
 }
 
 size_t vlqEncodeArray(const uint32_t* values, size_t count, uint8_t* buffer) {
-  size_t total_size = 0;
-  for (size_t i = 0; i < count; i++) {
-    total_size += vlqEncode(values[i], buffer + total_size);
-  }
-  return total_size;
+  return vlqEncodeValues(values, count, buffer);
+}
+
+size_t vlqEncodeArray(const uint32_t* values, size_t count,
+                      std::vector<uint8_t>& buffer) {
+  return vlqAppendValues(values, count, buffer);
 }
 
 size_t vlqDecodeArray(const uint8_t* buffer, size_t count, uint32_t* values) {
+  return vlqDecodeValues(buffer, count, values);
+}
+
+size_t vlqDecodeArrayScalar(const uint8_t* buffer, size_t count,
+                            uint32_t* values) {
   size_t totalSize = 0;
   for (size_t i = 0; i < count; i++) {
     totalSize += vlqDecode(buffer + totalSize, &values[i]);
   }
   return totalSize;
 }
+
+size_t vlqEncodeChecked(uint32_t value, std::span<uint8_t> buffer) {
+  if (vlqEncodedSize(value) > buffer.size()) {
+    return 0;
+  }
+  return vlqEncodeValue(value, buffer.data());
+}
+
+VlqEncodeResult vlqEncodeArrayChecked(const uint32_t* values, size_t count,
+                                      std::span<uint8_t> buffer) {
+  return vlqEncodeValuesChecked(values, count, buffer);
+}
+
+VlqDecodeResult vlqDecodeArrayUntilEnd(std::span<const uint8_t> buffer,
+                                       std::span<uint32_t> values) {
+  return vlqDecodeValuesUntilEnd(buffer, values);
+}
+
+size_t leb128Encode(uint32_t value, uint8_t* buffer) {
+  return vlqEncodeValue<uint32_t, VlqOrder::kLsbFirst>(value, buffer);
+}
+
+size_t leb128Decode(const uint8_t* buffer, uint32_t* value) {
+  return vlqDecodeValue<uint32_t, VlqOrder::kLsbFirst>(buffer, value);
+}
+
+size_t leb128EncodeArray(const uint32_t* values, size_t count,
+                         uint8_t* buffer) {
+  return vlqEncodeValues<uint32_t, VlqOrder::kLsbFirst>(values, count, buffer);
+}
+
+size_t leb128DecodeArray(const uint8_t* buffer, size_t count,
+                         uint32_t* values) {
+  return vlqDecodeValues<uint32_t, VlqOrder::kLsbFirst>(buffer, count, values);
+}
+
+namespace {
+
+/**
+ * @brief Adds the byte at the given index of a value to its groups so far.
+ *
+ * Groups past the 32 bits of the value (over-long LEB128) are dropped.
+ */
+template <VlqOrder ORDER>
+uint32_t appendGroup(uint32_t value, size_t index, uint8_t byte) {
+  if constexpr (ORDER == VlqOrder::kMsbFirst) {
+    return (value << 7) | (byte & 0x7F);
+  } else {
+    return 7 * index < 32 ? value | (uint32_t{byte & 0x7Fu} << (7 * index))
+                          : value;
+  }
+}
+
+}  // namespace
+
+template <VlqOrder ORDER>
+VlqStreamResult BasicVlqStreamDecoder<ORDER>::decode(
+    std::span<const uint8_t> chunk, std::span<uint32_t> values) {
+  const uint8_t* in = chunk.data();
+  const uint8_t* const end = in + chunk.size();
+  uint32_t* out = values.data();
+  uint32_t* const outEnd = out + values.size();
+  uint32_t partial = _partial;
+  size_t partialBytes = _partialBytes;
+
+  while (in < end && out < outEnd) {
+    if (partialBytes == 0 &&
+        static_cast<size_t>(end - in) >= kVlqMaxBytes<uint32_t>) {
+      // Fast path: a whole value fits in what is left of the chunk.
+      uint32_t value = 0;
+      size_t size = 0;
+      uint8_t byte;
+      do {
+        byte = in[size];
+        value = appendGroup<ORDER>(value, size++, byte);
+      } while ((byte & 0x80) && size < kVlqMaxBytes<uint32_t>);
+      in += size;
+      if (byte & 0x80) {
+        // Over-long value, finish it one byte at a time.
+        partial = value;
+        partialBytes = size;
+      } else {
+        *out++ = value;
+      }
+      continue;
+    }
+
+    const uint8_t byte = *in++;
+    partial = appendGroup<ORDER>(partial, partialBytes++, byte);
+    if (!(byte & 0x80)) {
+      *out++ = partial;
+      partial = 0;
+      partialBytes = 0;
+    }
+  }
+
+  _partial = partial;
+  _partialBytes = partialBytes;
+  return VlqStreamResult{.consumed = static_cast<size_t>(in - chunk.data()),
+                         .decoded = static_cast<size_t>(out - values.data())};
+}
+
+template class BasicVlqStreamDecoder<VlqOrder::kMsbFirst>;
+template class BasicVlqStreamDecoder<VlqOrder::kLsbFirst>;
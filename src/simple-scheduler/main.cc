@@ -89,13 +89,11 @@ struct MyRunnable {
  *
  * @param delay The duration in milliseconds after which the task should
  * execute.
- * @return std::time_t The absolute time when the task should be executed.
+ * @return scheduler::TimePoint The absolute time when the task should be
+ * executed.
  */
-std::time_t absoluteTime(std::chrono::milliseconds delay) {
-  using std::chrono::system_clock;
-  system_clock::time_point timePoint = system_clock::now() + delay;
-
-  return std::chrono::system_clock::to_time_t(timePoint);
+scheduler::TimePoint absoluteTime(std::chrono::milliseconds delay) {
+  return scheduler::Clock::now() + delay;
 }
 
 /**
@@ -143,12 +141,11 @@ void demo() {
   std::cout << "Stopping" << std::endl;
   std::this_thread::sleep_for(2s);
 
-  // Stops the dispatcher (it will no longer spawn expiring threads).
-  dispatcher.stop();
+  // Stops the dispatcher (it will no longer run expiring tasks). Draining
+  // waits for the tasks already handed to the workers.
+  dispatcher.stop(true);
 
   std::cout << "No more scheduled tasks, bye: " << std::endl;
-  // Problem: We don't have control over the threads spawned by the dispatcher.
-  // It does not guarantee that all scheduled threads have finished.
 }
 
 int main() {
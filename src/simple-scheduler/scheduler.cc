@@ -8,32 +8,93 @@
  * @brief Function Scheduler Implementation
  *
  * This scheduler is designed to execute functions only
- * once at their scheduled.
- * time with a precision of 1 millisecond.
+ * once at their scheduled time.
  *
  */
 
 #include "scheduler.h"
 
+#include <algorithm>
+
 namespace scheduler {
 using ScheduledFunction = std::function<void()>;
 
-void Scheduler::scheduleFunction(ScheduledFunction func,
-                                 time_t absoluteExpirationTime) {
-  std::lock_guard<std::mutex> guard(_mtx);
-  _minHeap.push(
-      ScheduleInfo{.expirationTime = absoluteExpirationTime, .function = func});
+void notifyWaiters(std::mutex& mtx, std::condition_variable& cv) {
+  { std::lock_guard<std::mutex> guard(mtx); }
+  cv.notify_all();
+}
+
+TimePoint deadlineAfter(Clock::duration wait) {
+  const TimePoint now = Clock::now();
+  return wait >= TimePoint::max() - now ? TimePoint::max() : now + wait;
+}
+
+TaskHandle Scheduler::scheduleFunction(ScheduledFunction func,
+                                       TimePoint absoluteExpirationTime) {
+  TaskHandle handle;
+  bool isEarliest;
+  {
+    std::lock_guard<std::mutex> guard(_mtx);
+    if (_freeSlots.empty()) {
+      handle.slot = static_cast<uint32_t>(_tasks.size());
+      _tasks.emplace_back();
+    } else {
+      handle.slot = _freeSlots.back();
+      _freeSlots.pop_back();
+    }
+    handle.generation = _tasks[handle.slot].generation;
+    _tasks[handle.slot].function = std::move(func);
+    _numPending++;
+
+    dropStaleTop();
+    isEarliest = _minHeap.empty() ||
+                 absoluteExpirationTime < _minHeap.front().expirationTime;
+    _minHeap.push_back(
+        ScheduleInfo{.expirationTime = absoluteExpirationTime, .task = handle});
+    std::push_heap(_minHeap.begin(), _minHeap.end(),
+                   std::greater<ScheduleInfo>());
+  }
+  // A later deadline does not change how long the waiters sleep.
+  if (isEarliest) {
+    _earliestChanged.notify_all();
+  }
+  return handle;
+}
+
+bool Scheduler::cancel(TaskHandle handle) {
+  return cancelUnlocked(_mtx, [this, handle](ScheduledFunction& cancelled) {
+    if (handle.slot >= _tasks.size() ||
+        _tasks[handle.slot].generation != handle.generation) {
+      return false;
+    }
+    cancelled = release(handle.slot);
+    _numPending--;
+
+    // Stale entries are dropped when they reach the top; rebuilding the heap
+    // once they are the majority bounds its size to twice the pending tasks.
+    if (_minHeap.size() > 2 * _numPending + 64) {
+      std::erase_if(_minHeap,
+                    [this](const ScheduleInfo& info) { return isStale(info); });
+      std::make_heap(_minHeap.begin(), _minHeap.end(),
+                     std::greater<ScheduleInfo>());
+    }
+    return true;
+  });
 }
 
 std::vector<ScheduledFunction> Scheduler::popReady(
-    std::time_t absoluteTimeNow) {
+    TimePoint absoluteTimeNow) {
   std::vector<ScheduledFunction> expiringFunctions;
   std::lock_guard<std::mutex> guard(_mtx);
 
   while (!_minHeap.empty()) {
-    if (auto next = _minHeap.top(); next.expirationTime <= absoluteTimeNow) {
-      _minHeap.pop();
-      expiringFunctions.push_back(next.function);
+    if (const auto next = _minHeap.front();
+        next.expirationTime <= absoluteTimeNow) {
+      popHeap();
+      if (!isStale(next)) {
+        expiringFunctions.push_back(release(next.task.slot));
+        _numPending--;
+      }
     } else {
       break;
     }
@@ -42,9 +103,59 @@ std::vector<ScheduledFunction> Scheduler::popReady(
   return expiringFunctions;
 }
 
+void Scheduler::waitUntilReady(const std::atomic<bool>& stopFlag,
+                               Clock::duration maxWait) {
+  const TimePoint giveUp = deadlineAfter(maxWait);
+  std::unique_lock<std::mutex> lock(_mtx);
+  while (!stopFlag.load()) {
+    dropStaleTop();
+    const TimePoint deadline = _minHeap.empty()
+                                   ? TimePoint::max()
+                                   : _minHeap.front().expirationTime;
+    if (deadline <= Clock::now()) {
+      return;
+    }
+    if (std::min(deadline, giveUp) == TimePoint::max()) {
+      _earliestChanged.wait(lock);
+    } else if (_earliestChanged.wait_until(lock, std::min(deadline, giveUp)) ==
+                   std::cv_status::timeout &&
+               giveUp <= Clock::now()) {
+      return;
+    }
+  }
+}
+
+void Scheduler::wakeWaiters() {
+  notifyWaiters(_mtx, _earliestChanged);
+}
+
 size_t Scheduler::getNumPendingTasks() const {
   std::lock_guard<std::mutex> guard(_mtx);
-  return _minHeap.size();
+  return _numPending;
+}
+
+bool Scheduler::isStale(const ScheduleInfo& info) const {
+  return _tasks[info.task.slot].generation != info.task.generation;
+}
+
+ScheduledFunction Scheduler::release(uint32_t slot) {
+  ScheduledFunction function = std::move(_tasks[slot].function);
+  _tasks[slot].function = nullptr;
+  _tasks[slot].generation++;
+  _freeSlots.push_back(slot);
+  return function;
+}
+
+void Scheduler::popHeap() {
+  std::pop_heap(_minHeap.begin(), _minHeap.end(),
+                std::greater<ScheduleInfo>());
+  _minHeap.pop_back();
+}
+
+void Scheduler::dropStaleTop() {
+  while (!_minHeap.empty() && isStale(_minHeap.front())) {
+    popHeap();
+  }
 }
 
 }  // namespace scheduler
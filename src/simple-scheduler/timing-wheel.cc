@@ -0,0 +1,234 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file timing-wheel.cc
+ * @brief Hierarchical Timing Wheel Scheduler Implementation
+ *
+ * A task at level l with deadline d shares every digit above l with the
+ * current tick and has a larger digit l, so its slot is reached exactly at
+ * tick d with the digits below l cleared. popReady() jumps from one such
+ * tick to the next, found from the occupancy bitmaps, instead of walking
+ * every tick in between.
+ *
+ */
+
+#include "timing-wheel.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace scheduler {
+
+TimingWheelScheduler::TimingWheelScheduler(Clock::duration tick)
+    : _tick(std::max(tick, Clock::duration{1})) {}
+
+uint64_t TimingWheelScheduler::toTick(Clock::duration time,
+                                      bool roundUp) const {
+  if (time <= Clock::duration::zero()) {
+    return 0;
+  }
+  const auto tick = static_cast<uint64_t>(time / _tick);
+  return roundUp && time % _tick != Clock::duration::zero() ? tick + 1 : tick;
+}
+
+TaskHandle TimingWheelScheduler::scheduleFunction(
+    ScheduledFunction func, TimePoint absoluteExpirationTime) {
+  std::unique_lock<std::mutex> lock(_mtx);
+  uint32_t node;
+  if (_freeNodes.empty()) {
+    node = static_cast<uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+  } else {
+    node = _freeNodes.back();
+    _freeNodes.pop_back();
+  }
+  // Rounded up: a task never fires before its deadline.
+  _nodes[node].deadline =
+      toTick(absoluteExpirationTime.time_since_epoch(), true);
+  _nodes[node].function = std::move(func);
+  // Waiters sleep until the next event, only an earlier deadline moves it.
+  const bool isEarliest =
+      _numWaiters > 0 && _nodes[node].deadline < nextEventTick();
+  place(node);
+  _numPending++;
+  const TaskHandle handle{.slot = node, .generation = _nodes[node].generation};
+  lock.unlock();
+  if (isEarliest) {
+    _earliestChanged.notify_all();
+  }
+  return handle;
+}
+
+bool TimingWheelScheduler::cancel(TaskHandle handle) {
+  return cancelUnlocked(_mtx, [this, handle](ScheduledFunction& cancelled) {
+    if (handle.slot >= _nodes.size() ||
+        _nodes[handle.slot].generation != handle.generation) {
+      return false;
+    }
+    unlink(handle.slot);
+    cancelled = release(handle.slot);
+    return true;
+  });
+}
+
+std::vector<ScheduledFunction> TimingWheelScheduler::popReady(
+    TimePoint absoluteTimeNow) {
+  std::vector<ScheduledFunction> expiringFunctions;
+  std::lock_guard<std::mutex> guard(_mtx);
+
+  const uint64_t target = toTick(absoluteTimeNow.time_since_epoch(), false);
+  expire(_due, expiringFunctions);
+  for (uint64_t next = nextEventTick(); next <= target;
+       next = nextEventTick()) {
+    _now = next;
+    processTick(expiringFunctions);
+  }
+  _now = std::max(_now, target);
+
+  return expiringFunctions;
+}
+
+void TimingWheelScheduler::waitUntilReady(const std::atomic<bool>& stopFlag,
+                                          Clock::duration maxWait) {
+  const TimePoint giveUp = deadlineAfter(maxWait);
+  std::unique_lock<std::mutex> lock(_mtx);
+  _numWaiters++;
+  const uint64_t lastTick = Clock::duration::max() / _tick;
+  while (!stopFlag.load() && _due.head == kNil) {
+    const uint64_t next = nextEventTick();
+    // Empty, or beyond the clock's range: no slot to wake up for.
+    const TimePoint wakeUp =
+        next > lastTick ? TimePoint::max()
+                        : TimePoint{} + _tick * static_cast<Clock::rep>(next);
+    if (wakeUp <= Clock::now()) {
+      break;
+    }
+    if (std::min(wakeUp, giveUp) == TimePoint::max()) {
+      _earliestChanged.wait(lock);
+    } else if (_earliestChanged.wait_until(lock, std::min(wakeUp, giveUp)) ==
+                   std::cv_status::timeout &&
+               giveUp <= Clock::now()) {
+      break;
+    }
+  }
+  _numWaiters--;
+}
+
+void TimingWheelScheduler::wakeWaiters() {
+  notifyWaiters(_mtx, _earliestChanged);
+}
+
+size_t TimingWheelScheduler::getNumPendingTasks() const {
+  std::lock_guard<std::mutex> guard(_mtx);
+  return _numPending;
+}
+
+uint64_t TimingWheelScheduler::nextEventTick() const {
+  uint64_t next = UINT64_MAX;
+  for (int level = 0; level < kLevels; level++) {
+    if (_occupied[level] == 0) {
+      continue;
+    }
+    const int shift = level * kSlotBits;
+    const int highShift = shift + kSlotBits;
+    const uint64_t high =
+        highShift >= 64 ? 0 : (_now >> highShift) << highShift;
+    const uint64_t slot = std::countr_zero(_occupied[level]);
+    next = std::min(next, high | (slot << shift));
+  }
+  return next;
+}
+
+TimingWheelScheduler::List& TimingWheelScheduler::bucketList(
+    uint16_t bucket) {
+  return bucket == kDueBucket ? _due
+                              : _slots[bucket / kSlots][bucket % kSlots];
+}
+
+void TimingWheelScheduler::append(uint16_t bucket, uint32_t node) {
+  List& list = bucketList(bucket);
+  _nodes[node].bucket = bucket;
+  _nodes[node].prev = list.tail;
+  _nodes[node].next = kNil;
+  if (list.tail == kNil) {
+    list.head = node;
+  } else {
+    _nodes[list.tail].next = node;
+  }
+  list.tail = node;
+}
+
+void TimingWheelScheduler::unlink(uint32_t node) {
+  const uint16_t bucket = _nodes[node].bucket;
+  List& list = bucketList(bucket);
+  const uint32_t prev = _nodes[node].prev;
+  const uint32_t next = _nodes[node].next;
+  (prev == kNil ? list.head : _nodes[prev].next) = next;
+  (next == kNil ? list.tail : _nodes[next].prev) = prev;
+  if (list.head == kNil && bucket != kDueBucket) {
+    _occupied[bucket / kSlots] &= ~(uint64_t{1} << (bucket % kSlots));
+  }
+}
+
+ScheduledFunction TimingWheelScheduler::release(uint32_t node) {
+  ScheduledFunction function = std::move(_nodes[node].function);
+  _nodes[node].function = nullptr;
+  _nodes[node].generation++;
+  _freeNodes.push_back(node);
+  _numPending--;
+  return function;
+}
+
+void TimingWheelScheduler::place(uint32_t node) {
+  const uint64_t deadline = _nodes[node].deadline;
+  if (deadline <= _now) {
+    append(kDueBucket, node);
+    return;
+  }
+  // The highest digit where the deadline and the current tick differ.
+  const int level = (std::bit_width(deadline ^ _now) - 1) / kSlotBits;
+  const size_t slot = (deadline >> (level * kSlotBits)) & (kSlots - 1);
+  append(static_cast<uint16_t>(level * kSlots + slot), node);
+  _occupied[level] |= uint64_t{1} << slot;
+}
+
+void TimingWheelScheduler::expire(List& list,
+                                  std::vector<ScheduledFunction>& ready) {
+  for (uint32_t node = list.head; node != kNil; node = _nodes[node].next) {
+    ready.push_back(release(node));
+  }
+  list = List{};
+}
+
+void TimingWheelScheduler::processTick(std::vector<ScheduledFunction>& ready) {
+  // Higher levels first: their tasks due at _now join _due, expired below.
+  for (int level = kLevels - 1; level > 0; level--) {
+    const int shift = level * kSlotBits;
+    if ((_now & ((uint64_t{1} << shift) - 1)) != 0) {
+      continue;
+    }
+    const size_t slot = (_now >> shift) & (kSlots - 1);
+    if ((_occupied[level] & (uint64_t{1} << slot)) == 0) {
+      continue;
+    }
+    const List cascaded = _slots[level][slot];
+    _slots[level][slot] = List{};
+    _occupied[level] &= ~(uint64_t{1} << slot);
+    for (uint32_t node = cascaded.head; node != kNil;) {
+      const uint32_t next = _nodes[node].next;
+      place(node);
+      node = next;
+    }
+  }
+  const size_t slot = _now & (kSlots - 1);
+  if ((_occupied[0] & (uint64_t{1} << slot)) != 0) {
+    _occupied[0] &= ~(uint64_t{1} << slot);
+    expire(_slots[0][slot], ready);
+  }
+  expire(_due, ready);
+}
+
+}  // namespace scheduler
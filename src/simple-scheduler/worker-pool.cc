@@ -0,0 +1,115 @@
+// Copyright (c) 2025 gyrok42.com
+//
+// This software is released under the MIT License.
+// https://opensource.org/licenses/MIT
+
+/**
+ * @file worker-pool.cc
+ * @brief Worker Pool Implementation
+ *
+ */
+
+#include "worker-pool.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace scheduler {
+
+WorkerPool::WorkerPool(size_t numWorkers)
+    : _numWorkers(std::max<size_t>(numWorkers, 1)) {
+  _workers.reserve(_numWorkers);
+  for (size_t i = 0; i < _numWorkers; i++) {
+    _workers.emplace_back(&WorkerPool::runWorker, this);
+  }
+}
+
+WorkerPool::~WorkerPool() { stop(); }
+
+size_t WorkerPool::defaultNumWorkers() {
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+bool WorkerPool::submit(ScheduledFunction func) {
+  {
+    std::lock_guard<std::mutex> guard(_mtx);
+    if (_stopping) {
+      return false;
+    }
+    _queue.push_back(std::move(func));
+  }
+  _ready.notify_one();
+  return true;
+}
+
+bool WorkerPool::submit(std::vector<ScheduledFunction> functions) {
+  if (functions.empty()) {
+    return true;
+  }
+  {
+    std::lock_guard<std::mutex> guard(_mtx);
+    if (_stopping) {
+      return false;
+    }
+    std::move(functions.begin(), functions.end(), std::back_inserter(_queue));
+  }
+  if (functions.size() == 1) {
+    _ready.notify_one();
+  } else {
+    _ready.notify_all();
+  }
+  return true;
+}
+
+void WorkerPool::waitIdle() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  _idle.wait(lock, [this] { return _queue.empty() && _running == 0; });
+}
+
+void WorkerPool::stop(bool drain) {
+  std::deque<ScheduledFunction> dropped;
+  std::vector<std::thread> workers;
+  {
+    std::unique_lock<std::mutex> lock(_mtx);
+    if (drain) {
+      _idle.wait(lock, [this] { return _queue.empty() && _running == 0; });
+    }
+    _stopping = true;
+    dropped.swap(_queue);
+    workers.swap(_workers);
+  }
+  _ready.notify_all();
+  _idle.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+size_t WorkerPool::getNumInFlightTasks() const {
+  std::lock_guard<std::mutex> guard(_mtx);
+  return _queue.size() + _running;
+}
+
+void WorkerPool::runWorker() {
+  std::unique_lock<std::mutex> lock(_mtx);
+  for (;;) {
+    _ready.wait(lock, [this] { return _stopping || !_queue.empty(); });
+    if (_stopping) {
+      return;
+    }
+    auto func = std::move(_queue.front());
+    _queue.pop_front();
+    _running++;
+    lock.unlock();
+
+    func();
+    func = nullptr;  // Releases the closure outside the lock
+
+    lock.lock();
+    if (--_running == 0 && _queue.empty()) {
+      _idle.notify_all();
+    }
+  }
+}
+
+}  // namespace scheduler
@@ -0,0 +1,69 @@
+/**
+ * @file block-codec-test.cc
+ * @brief Unit tests for blocks with a format chosen per block.
+ */
+
+// standard includes
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "block-codec.h"
+#include "pfor.h"
+#include "vlq.h"
+
+/**
+ * @brief Tests that blocks of any format decode back to their values.
+ */
+TEST(BlockCodecTest, RoundTripEveryFormat) {
+  std::vector<uint32_t> values;
+  for (uint32_t i = 0; i < 1000; i++) {
+    values.push_back(i * i * 37);
+  }
+  for (auto format : {BlockFormat::kVlq, BlockFormat::kStreamVByte,
+                      BlockFormat::kPfor, BlockFormat::kDictionary}) {
+    std::vector<uint8_t> buffer(blockMaxEncodedSize(values.size()));
+    size_t size =
+        encodeBlock(format, values.data(), values.size(), buffer.data());
+    EXPECT_EQ(buffer[0], static_cast<uint8_t>(format));
+
+    std::vector<uint32_t> decoded(values.size());
+    EXPECT_EQ(decodeBlock(buffer.data(), values.size(), decoded.data()), size);
+    EXPECT_EQ(decoded, values);
+  }
+}
+
+/**
+ * @brief Tests that a VLQ block is a tag followed by plain VLQ data.
+ */
+TEST(BlockCodecTest, VlqBlockLayout) {
+  uint32_t values[] = {127, 128};
+  uint8_t buffer[16];
+  EXPECT_EQ(encodeBlock(BlockFormat::kVlq, values, 2, buffer), 4);
+  EXPECT_EQ(buffer[0], 0);
+  EXPECT_EQ(buffer[1], 0x7F);
+  EXPECT_EQ(buffer[2], 0x81);
+  EXPECT_EQ(buffer[3], 0x00);
+}
+
+/**
+ * @brief Tests that an unknown format is reported.
+ */
+TEST(BlockCodecTest, UnknownFormat) {
+  uint8_t buffer[] = {0xFF, 0x00};
+  uint32_t value;
+  EXPECT_EQ(decodeBlock(buffer, 1, &value), 0);
+}
+
+/**
+ * @brief Tests that a PFOR block with a corrupt bit width is reported.
+ */
+TEST(BlockCodecTest, CorruptPforBlock) {
+  std::vector<uint32_t> values(kPforBlockSize, 7);
+  std::vector<uint8_t> buffer(1 + pforMaxEncodedSize(values.size()));
+  encodeBlock(BlockFormat::kPfor, values.data(), values.size(), buffer.data());
+  buffer[1 + 4] = 0xFF;  // bits
+  EXPECT_EQ(decodeBlock(buffer.data(), values.size(), values.data()), 0);
+}
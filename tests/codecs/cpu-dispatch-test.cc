@@ -0,0 +1,95 @@
+/**
+ * @file cpu-dispatch-test.cc
+ * @brief Unit tests for the runtime kernel selection using Google Test.
+ */
+
+// standard includes
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "cpu-dispatch.h"
+#include "stream-vbyte.h"
+#include "vlq-aggregate.h"
+#include "vlq.h"
+
+/**
+ * @brief Random values of 0 to 32 bits.
+ */
+static std::vector<uint32_t> randomValues(size_t count) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(count);
+  for (auto& value : values) {
+    int width = gen() % 33;
+    value = width == 0 ? 0 : gen() >> (32 - width);
+  }
+  return values;
+}
+
+/**
+ * @brief Tests that tiers above the detected one are refused.
+ */
+TEST(CpuDispatchTest, ForceTier) {
+  const CpuTier detected = cpuDetectedTier();
+  EXPECT_LE(cpuTier(), detected);
+  EXPECT_TRUE(cpuForceTier(CpuTier::kScalar));
+  EXPECT_EQ(cpuTier(), CpuTier::kScalar);
+  if (detected != CpuTier::kAvx512) {
+    EXPECT_FALSE(cpuForceTier(CpuTier::kAvx512));
+    EXPECT_EQ(cpuTier(), CpuTier::kScalar);
+  }
+  EXPECT_TRUE(cpuForceTier(detected));
+  EXPECT_EQ(cpuTier(), detected);
+  EXPECT_STREQ(cpuTierName(CpuTier::kSse41), "sse4.1");
+}
+
+/**
+ * @brief Tests that every supported tier gives the same results, including
+ * kernels bound before the tier changes.
+ */
+TEST(CpuDispatchTest, EveryTierMatches) {
+  const auto values = randomValues(1000);
+  std::vector<uint8_t> expected(values.size() * kVlqMaxBytes<uint32_t>);
+  expected.resize(
+      vlqEncodeArray(values.data(), values.size(), expected.data()));
+  std::vector<uint8_t> svbExpected(streamVByteMaxEncodedSize(values.size()));
+  svbExpected.resize(streamVByteEncodeArrayScalar(
+      values.data(), values.size(), svbExpected.data()));
+  uint64_t sum = 0;
+  for (uint32_t value : values) {
+    sum += value;
+  }
+
+  for (size_t i = 0; i <= static_cast<size_t>(cpuDetectedTier()); i++) {
+    const auto tier = static_cast<CpuTier>(i);
+    ASSERT_TRUE(cpuForceTier(tier));
+    SCOPED_TRACE(cpuTierName(tier));
+
+    std::vector<uint32_t> decoded(values.size());
+    EXPECT_EQ(vlqDecodeArray(expected.data(), values.size(), decoded.data()),
+              expected.size());
+    EXPECT_EQ(decoded, values);
+    EXPECT_EQ(vlqCountValues(expected.data(), expected.size()), values.size());
+    for (size_t size : {0, 1, 63, 100, 129}) {
+      EXPECT_EQ(vlqCountValues(expected.data(), size),
+                std::count_if(expected.begin(), expected.begin() + size,
+                              [](uint8_t byte) { return byte < 0x80; }));
+    }
+    EXPECT_EQ(vlqEncodedSizeArray(values.data(), values.size()),
+              expected.size());
+    EXPECT_EQ(vlqSumArray(expected.data(), values.size()).sum, sum);
+
+    std::vector<uint8_t> svb(streamVByteMaxEncodedSize(values.size()));
+    svb.resize(streamVByteEncodeArray(values.data(), values.size(),
+                                      svb.data()));
+    EXPECT_EQ(svb, svbExpected);
+    std::fill(decoded.begin(), decoded.end(), 0);
+    streamVByteDecodeArray(svb.data(), values.size(), decoded.data());
+    EXPECT_EQ(decoded, values);
+  }
+  cpuForceTier(cpuDetectedTier());
+}
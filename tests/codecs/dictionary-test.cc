@@ -0,0 +1,80 @@
+/**
+ * @file dictionary-test.cc
+ * @brief Unit tests for dictionary encoding.
+ */
+
+// standard includes
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "cpu-dispatch.h"
+#include "dictionary.h"
+#include "vlq.h"
+
+/**
+ * @brief Large values drawn from a set of the given size.
+ */
+static std::vector<uint32_t> lowCardinalityValues(size_t count,
+                                                  size_t distinct) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> set(distinct);
+  for (auto& value : set) {
+    value = gen() | (1u << 28);
+  }
+  std::vector<uint32_t> values(count);
+  for (auto& value : values) {
+    value = set[gen() % distinct];
+  }
+  return values;
+}
+
+/**
+ * @brief Encodes, checks the size bound and decodes with every tier.
+ * @return The encoded size.
+ */
+static size_t checkRoundTrip(const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> buffer(dictionaryMaxEncodedSize(values.size()));
+  const size_t size =
+      dictionaryEncodeArray(values.data(), values.size(), buffer.data());
+  EXPECT_LE(size, buffer.size());
+
+  for (size_t i = 0; i <= static_cast<size_t>(cpuDetectedTier()); i++) {
+    EXPECT_TRUE(cpuForceTier(static_cast<CpuTier>(i)));
+    std::vector<uint32_t> decoded(values.size());
+    EXPECT_EQ(
+        dictionaryDecodeArray(buffer.data(), values.size(), decoded.data()),
+        size);
+    EXPECT_EQ(decoded, values);
+  }
+  cpuForceTier(cpuDetectedTier());
+  return size;
+}
+
+/**
+ * @brief Tests partial and several blocks, and every value distinct.
+ */
+TEST(DictionaryTest, RoundTrip) {
+  for (size_t count : {size_t{0}, size_t{1}, size_t{127},
+                       kDictionaryBlockSize, 3 * kDictionaryBlockSize + 5}) {
+    checkRoundTrip(lowCardinalityValues(count, 300));
+  }
+  std::vector<uint32_t> distinct(kDictionaryBlockSize + 1);
+  for (size_t i = 0; i < distinct.size(); i++) {
+    distinct[i] = static_cast<uint32_t>(i * 2654435761u);
+  }
+  checkRoundTrip(distinct);
+}
+
+/**
+ * @brief Tests that a few hundred large distinct values take well under
+ * half the VLQ size.
+ */
+TEST(DictionaryTest, SmallerThanVlqForFewValues) {
+  const auto values = lowCardinalityValues(4 * kDictionaryBlockSize, 300);
+  const size_t size = checkRoundTrip(values);
+  EXPECT_LT(2 * size, vlqEncodedSizeArray(values.data(), values.size()));
+}
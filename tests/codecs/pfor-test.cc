@@ -0,0 +1,136 @@
+/**
+ * @file pfor-test.cc
+ * @brief Unit tests for patched frame-of-reference encoding.
+ */
+
+// standard includes
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "pfor.h"
+#include "vlq.h"
+
+/**
+ * @brief Encodes with the SIMD and scalar paths, checks that they agree and
+ * decode back to the values.
+ * @return The encoded size.
+ */
+static size_t checkRoundTrip(const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> buffer(pforMaxEncodedSize(values.size()));
+  std::vector<uint8_t> scalar(buffer.size());
+  const size_t size = pforEncodeArray(values.data(), values.size(),
+                                      buffer.data());
+  EXPECT_LE(size, buffer.size());
+  EXPECT_EQ(pforEncodeArrayScalar(values.data(), values.size(),
+                                  scalar.data()),
+            size);
+  EXPECT_EQ(buffer, scalar);
+
+  std::vector<uint32_t> decoded(values.size());
+  EXPECT_EQ(pforDecodeArray(buffer.data(), values.size(), decoded.data()),
+            size);
+  EXPECT_EQ(decoded, values);
+  std::fill(decoded.begin(), decoded.end(), 0);
+  EXPECT_EQ(
+      pforDecodeArrayScalar(buffer.data(), values.size(), decoded.data()),
+      size);
+  EXPECT_EQ(decoded, values);
+  return size;
+}
+
+/**
+ * @brief Tests every bit width, around a non-zero reference.
+ */
+TEST(PforTest, EveryBitWidth) {
+  std::mt19937 gen(42);
+  for (unsigned bits = 0; bits <= 32; bits++) {
+    std::vector<uint32_t> values(kPforBlockSize * 3);
+    for (auto& value : values) {
+      const uint32_t delta = bits == 0 ? 0 : gen() >> (32 - bits);
+      value = 1000 + delta;
+    }
+    checkRoundTrip(values);
+  }
+}
+
+/**
+ * @brief Tests counts that end in a partial block.
+ */
+TEST(PforTest, PartialBlocks) {
+  std::mt19937 gen(7);
+  for (size_t count : {0, 1, 127, 128, 129, 255, 1000}) {
+    std::vector<uint32_t> values(count);
+    for (auto& value : values) {
+      value = gen() >> (gen() % 32);
+    }
+    checkRoundTrip(values);
+  }
+}
+
+/**
+ * @brief Tests that outliers become exceptions instead of widening the whole
+ * block.
+ */
+TEST(PforTest, ExceptionsKeepBlocksNarrow) {
+  std::mt19937 gen(3);
+  std::vector<uint32_t> values(kPforBlockSize * 8);
+  for (auto& value : values) {
+    value = 5000 + gen() % 16;
+  }
+  for (size_t i = 0; i < values.size(); i += 50) {
+    values[i] = ~0u - i;
+  }
+  const size_t size = checkRoundTrip(values);
+
+  // 4 bits per value plus a few exceptions, where VLQ needs 2 bytes each.
+  std::vector<uint8_t> vlq(values.size() * kVlqMaxBytes<uint32_t>);
+  EXPECT_LT(size, values.size());
+  EXPECT_LT(size, vlqEncodeArray(values.data(), values.size(), vlq.data()));
+}
+
+/**
+ * @brief Tests the layout of a constant block: header only.
+ */
+TEST(PforTest, ConstantBlock) {
+  std::vector<uint32_t> values(kPforBlockSize, 0x01020304);
+  std::vector<uint8_t> buffer(pforMaxEncodedSize(values.size()));
+  ASSERT_EQ(pforEncodeArray(values.data(), values.size(), buffer.data()), 6);
+  EXPECT_EQ(buffer[0], 0x04);
+  EXPECT_EQ(buffer[3], 0x01);
+  EXPECT_EQ(buffer[4], 0);  // bits
+  EXPECT_EQ(buffer[5], 0);  // exceptions
+  checkRoundTrip(values);
+}
+
+/**
+ * @brief Tests that a corrupt block header is rejected before unpacking.
+ */
+TEST(PforTest, CorruptHeader) {
+  std::vector<uint32_t> values(kPforBlockSize, 7);
+  values[3] = 1000;
+  std::vector<uint8_t> buffer(pforMaxEncodedSize(values.size()) + 64);
+  pforEncodeArray(values.data(), values.size(), buffer.data());
+  ASSERT_GT(buffer[5], 0);  // exceptions
+  std::vector<uint32_t> decoded(values.size());
+
+  std::vector<uint8_t> corrupt = buffer;
+  corrupt[6 + kPforBlockSize * corrupt[4] / 8] = kPforBlockSize;  // position
+  EXPECT_EQ(pforDecodeArray(corrupt.data(), values.size(), decoded.data()), 0);
+  for (uint8_t bits : {33, 200, 255}) {
+    corrupt = buffer;
+    corrupt[4] = bits;
+    EXPECT_EQ(pforDecodeArray(corrupt.data(), values.size(), decoded.data()),
+              0);
+    EXPECT_EQ(
+        pforDecodeArrayScalar(corrupt.data(), values.size(), decoded.data()),
+        0);
+  }
+  corrupt = buffer;
+  corrupt[4] = 32;
+  EXPECT_EQ(pforDecodeArray(corrupt.data(), values.size(), decoded.data()), 0);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file stream-vbyte-test.cc
+ * @brief Unit tests for Stream VByte encoding and decoding using Google Test.
+ */
+
+// standard includes
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "stream-vbyte.h"
+
+/**
+ * @brief Random values of 0 to 32 bits.
+ */
+static std::vector<uint32_t> randomValues(size_t count) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(count);
+  for (auto& value : values) {
+    int width = gen() % 33;
+    value = width == 0 ? 0 : gen() >> (32 - width);
+  }
+  return values;
+}
+
+/**
+ * @brief Tests the layout of control and data bytes.
+ */
+TEST(StreamVByteTest, EncodeLayout) {
+  uint32_t values[] = {0x01, 0x0203, 0x040506, 0x0708090A, 0x0B};
+  uint8_t buffer[streamVByteMaxEncodedSize(5)];
+  size_t size = streamVByteEncodeArray(values, 5, buffer);
+
+  EXPECT_EQ(size, 2 + 1 + 2 + 3 + 4 + 1);
+  EXPECT_EQ(buffer[0], 0b11100100);
+  EXPECT_EQ(buffer[1], 0b00000000);
+  EXPECT_EQ(buffer[2], 0x01);
+  EXPECT_EQ(buffer[3], 0x03);
+  EXPECT_EQ(buffer[4], 0x02);
+  EXPECT_EQ(buffer[12], 0x0B);
+}
+
+/**
+ * @brief Tests that the SIMD paths match the scalar paths.
+ */
+TEST(StreamVByteTest, SimdMatchesScalar) {
+  for (size_t count : {0, 1, 4, 15, 16, 17, 63, 1000}) {
+    auto values = randomValues(count);
+    std::vector<uint8_t> scalar(streamVByteMaxEncodedSize(count));
+    std::vector<uint8_t> simd(streamVByteMaxEncodedSize(count));
+    size_t size =
+        streamVByteEncodeArrayScalar(values.data(), count, scalar.data());
+    EXPECT_EQ(streamVByteEncodeArray(values.data(), count, simd.data()), size);
+    EXPECT_EQ(simd, scalar);
+
+    // Exact-size input, overreads are caught by sanitizers.
+    simd.resize(size);
+    std::vector<uint32_t> decoded(count);
+    std::vector<uint32_t> decodedScalar(count);
+    EXPECT_EQ(streamVByteDecodeArray(simd.data(), count, decoded.data()),
+              size);
+    EXPECT_EQ(
+        streamVByteDecodeArrayScalar(simd.data(), count, decodedScalar.data()),
+        size);
+    EXPECT_EQ(decoded, values);
+    EXPECT_EQ(decodedScalar, values);
+  }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file vlq-aggregate-test.cc
+ * @brief Unit tests for aggregates computed from VLQ-encoded arrays.
+ */
+
+// standard includes
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "vlq-aggregate.h"
+#include "vlq.h"
+
+/**
+ * @brief Values of every encoded length, in runs so that every kind of
+ * decode step (single bytes, 16-bit and 32-bit lanes, long values) is used.
+ */
+static std::vector<uint32_t> mixedValues(size_t count, uint32_t seed) {
+  std::mt19937 gen(seed);
+  std::vector<uint32_t> values(count);
+  for (size_t i = 0; i < count; i++) {
+    const int bits = 1 + (i / 40 + gen() % 3) % 32;
+    values[i] = gen() >> (32 - bits);
+  }
+  return values;
+}
+
+static std::vector<uint8_t> encode(const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  buffer.resize(vlqEncodeArray(values.data(), values.size(), buffer.data()));
+  return buffer;
+}
+
+/**
+ * @brief Tests sum, min/max and count against the decoded values.
+ */
+TEST(VLQAggregateTest, MatchesDecodedValues) {
+  for (size_t count : {0, 1, 15, 16, 33, 1000, 5000}) {
+    const auto values = mixedValues(count, count);
+    const auto buffer = encode(values);
+
+    const auto sum = vlqSumArray(buffer.data(), count);
+    EXPECT_EQ(sum.sum,
+              std::accumulate(values.begin(), values.end(), uint64_t{0}));
+    EXPECT_EQ(sum.consumed, buffer.size());
+
+    const auto minMax = vlqMinMaxArray(buffer.data(), count);
+    EXPECT_EQ(minMax.consumed, buffer.size());
+    if (count == 0) {
+      EXPECT_EQ(minMax.min, UINT32_MAX);
+      EXPECT_EQ(minMax.max, 0);
+    } else {
+      EXPECT_EQ(minMax.min, *std::min_element(values.begin(), values.end()));
+      EXPECT_EQ(minMax.max, *std::max_element(values.begin(), values.end()));
+    }
+
+    for (auto [low, high] : {std::pair<uint32_t, uint32_t>{0, UINT32_MAX},
+                             {0, 127},
+                             {100, 20000},
+                             {1u << 20, 1u << 30},
+                             {5, 5}}) {
+      const auto inRange = [&](uint32_t value) {
+        return value >= low && value <= high;
+      };
+      const auto counted =
+          vlqCountInRangeArray(buffer.data(), count, low, high);
+      EXPECT_EQ(counted.count,
+                std::count_if(values.begin(), values.end(), inRange));
+      EXPECT_EQ(counted.consumed, buffer.size());
+      EXPECT_EQ(vlqCountIfArray(buffer.data(), count, inRange).count,
+                counted.count);
+    }
+  }
+}
+
+/**
+ * @brief Tests that the minimum ignores the unused lanes of a step.
+ */
+TEST(VLQAggregateTest, MinIgnoresUnusedLanes) {
+  // Runs of 2-byte and 3-byte values, which decode a few lanes per step.
+  std::vector<uint32_t> values;
+  for (size_t i = 0; i < 200; i++) {
+    values.push_back(i % 64 < 32 ? 200 + i : 40000 + i);
+  }
+  const auto buffer = encode(values);
+  const auto minMax = vlqMinMaxArray(buffer.data(), values.size());
+  EXPECT_EQ(minMax.min, 200);
+  EXPECT_EQ(minMax.max, 40000 + 191);
+}
+
+/**
+ * @brief Tests that the visitor sees every value in order.
+ */
+TEST(VLQAggregateTest, VisitInOrder) {
+  const auto values = mixedValues(1000, 9);
+  const auto buffer = encode(values);
+  std::vector<uint32_t> visited;
+  EXPECT_EQ(vlqVisitArray(buffer.data(), values.size(),
+                          [&](uint32_t value) { visited.push_back(value); }),
+            buffer.size());
+  EXPECT_EQ(visited, values);
+}
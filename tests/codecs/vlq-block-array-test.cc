@@ -0,0 +1,96 @@
+/**
+ * @file vlq-block-array-test.cc
+ * @brief Unit tests for the VLQ-encoded array with a block index.
+ */
+
+// standard includes
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "vlq-block-array.h"
+#include "vlq.h"
+
+/**
+ * @brief Sorted values with gaps and repeats.
+ */
+static std::vector<uint32_t> sortedValues(size_t count) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(count);
+  uint32_t value = 0;
+  for (auto& v : values) {
+    value += gen() % 1000;
+    v = value;
+  }
+  return values;
+}
+
+/**
+ * @brief Tests that the data is a plain VLQ stream.
+ */
+TEST(VlqBlockArrayTest, DataIsVlqStream) {
+  auto values = sortedValues(1000);
+  VlqBlockArray array(values.data(), values.size(), 16);
+
+  std::vector<uint32_t> decoded(values.size());
+  EXPECT_EQ(vlqDecodeArray(array.data().data(), values.size(), decoded.data()),
+            array.data().size());
+  EXPECT_EQ(decoded, values);
+  EXPECT_EQ(array.size(), values.size());
+  EXPECT_EQ(array.encodedSize(), array.data().size() + 2 * 63 * 4);
+}
+
+/**
+ * @brief Tests random access to single values and ranges.
+ */
+TEST(VlqBlockArrayTest, GetAndDecodeRange) {
+  auto values = sortedValues(1000);
+  for (size_t blockSize : {1, 7, 128, 5000}) {
+    VlqBlockArray array(values.data(), values.size(), blockSize, false);
+    for (size_t i = 0; i < values.size(); i++) {
+      ASSERT_EQ(array.get(i), values[i]) << i;
+    }
+
+    uint32_t range[50];
+    EXPECT_EQ(array.decodeRange(333, 50, range), 50);
+    EXPECT_TRUE(std::equal(range, range + 50, values.begin() + 333));
+    EXPECT_EQ(array.decodeRange(990, 50, range), 10);
+    EXPECT_TRUE(std::equal(range, range + 10, values.begin() + 990));
+    EXPECT_EQ(array.decodeRange(1000, 50, range), 0);
+  }
+}
+
+/**
+ * @brief Tests lowerBound against std::lower_bound, with and without the
+ * first values in the index.
+ */
+TEST(VlqBlockArrayTest, LowerBound) {
+  auto values = sortedValues(1000);
+  for (bool indexFirstValues : {true, false}) {
+    VlqBlockArray array(values.data(), values.size(), 32, indexFirstValues);
+    for (uint32_t probe = 0; probe <= values.back() + 1; probe += 97) {
+      size_t expected =
+          std::lower_bound(values.begin(), values.end(), probe) -
+          values.begin();
+      ASSERT_EQ(array.lowerBound(probe), expected) << probe;
+    }
+    EXPECT_EQ(array.lowerBound(values[500]),
+              std::lower_bound(values.begin(), values.end(), values[500]) -
+                  values.begin());
+  }
+}
+
+/**
+ * @brief Tests an empty array.
+ */
+TEST(VlqBlockArrayTest, Empty) {
+  VlqBlockArray array(nullptr, 0);
+  uint32_t value;
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.decodeRange(0, 1, &value), 0);
+  EXPECT_EQ(array.lowerBound(5), 0);
+}
@@ -0,0 +1,96 @@
+/**
+ * @file vlq-delta-test.cc
+ * @brief Unit tests for delta and zigzag coding fused with VLQ.
+ */
+
+// standard includes
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "vlq-delta.h"
+#include "vlq.h"
+
+/**
+ * @brief Tests the zigzag mapping.
+ */
+TEST(VLQDeltaTest, Zigzag) {
+  EXPECT_EQ(zigzagEncode(0), 0);
+  EXPECT_EQ(zigzagEncode(-1), 1);
+  EXPECT_EQ(zigzagEncode(1), 2);
+  EXPECT_EQ(zigzagEncode(-2), 3);
+  EXPECT_EQ(zigzagEncode(INT_MAX), 0xFFFFFFFE);
+  EXPECT_EQ(zigzagEncode(INT_MIN), 0xFFFFFFFF);
+  for (int32_t value : {0, 1, -1, 64, -65, INT_MAX, INT_MIN}) {
+    EXPECT_EQ(zigzagDecode(zigzagEncode(value)), value);
+  }
+}
+
+/**
+ * @brief Tests that deltas are stored, not values.
+ */
+TEST(VLQDeltaTest, EncodeSorted) {
+  uint32_t values[] = {5, 7, 7, 200};
+  uint8_t buffer[20];
+  size_t size = vlqEncodeDeltaArray(values, 4, buffer);
+
+  ASSERT_EQ(size, 5);
+  EXPECT_EQ(buffer[0], 5);
+  EXPECT_EQ(buffer[1], 2);
+  EXPECT_EQ(buffer[2], 0);
+  EXPECT_EQ(buffer[3], 0x81);  // 193
+  EXPECT_EQ(buffer[4], 0x41);
+
+  uint32_t decoded[4];
+  EXPECT_EQ(vlqDecodeDeltaArray(buffer, 4, decoded), size);
+  EXPECT_TRUE(std::equal(values, values + 4, decoded));
+}
+
+/**
+ * @brief Tests a long sorted array, crossing several decode blocks.
+ */
+TEST(VLQDeltaTest, RoundTripPostingList) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(5000);
+  uint32_t value = 0;
+  for (auto& v : values) {
+    value += gen() % 300;
+    v = value;
+  }
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size =
+      vlqEncodeDeltaArray(values.data(), values.size(), buffer.data());
+  EXPECT_LT(size, values.size() * 2);
+
+  std::vector<uint32_t> decoded(values.size());
+  EXPECT_EQ(vlqDecodeDeltaArray(buffer.data(), values.size(), decoded.data()),
+            size);
+  EXPECT_EQ(decoded, values);
+}
+
+/**
+ * @brief Tests signed values, including wrapping deltas.
+ */
+TEST(VLQDeltaTest, RoundTripSigned) {
+  std::mt19937 gen(7);
+  std::vector<int32_t> values(3001);
+  for (auto& v : values) {
+    v = static_cast<int32_t>(gen() % 2001) - 1000;
+  }
+  values[10] = INT_MIN;
+  values[11] = INT_MAX;
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  size_t size =
+      vlqEncodeZigzagDeltaArray(values.data(), values.size(), buffer.data());
+
+  std::vector<int32_t> decoded(values.size());
+  EXPECT_EQ(
+      vlqDecodeZigzagDeltaArray(buffer.data(), values.size(), decoded.data()),
+      size);
+  EXPECT_EQ(decoded, values);
+}
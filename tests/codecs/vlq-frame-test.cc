@@ -0,0 +1,113 @@
+/**
+ * @file vlq-frame-test.cc
+ * @brief Unit tests for the checksummed VLQ frames using Google Test.
+ */
+
+// standard includes
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "cpu-dispatch.h"
+#include "vlq-frame.h"
+
+/**
+ * @brief Random values of 0 to 32 bits.
+ */
+static std::vector<uint32_t> randomValues(size_t count) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(count);
+  for (auto& value : values) {
+    int width = gen() % 33;
+    value = width == 0 ? 0 : gen() >> (32 - width);
+  }
+  return values;
+}
+
+static std::vector<uint8_t> encodeFrame(const std::vector<uint32_t>& values) {
+  std::vector<uint8_t> frame(vlqFrameMaxSize(values.size()));
+  frame.resize(vlqEncodeFrame(values.data(), values.size(), frame.data()));
+  return frame;
+}
+
+/**
+ * @brief Tests the CRC32C of every tier against the standard check value.
+ */
+TEST(VlqFrameTest, Crc32cCheckValue) {
+  const char* text = "123456789";
+  const auto* data = reinterpret_cast<const uint8_t*>(text);
+  for (size_t i = 0; i <= static_cast<size_t>(cpuDetectedTier()); i++) {
+    ASSERT_TRUE(cpuForceTier(static_cast<CpuTier>(i)));
+    EXPECT_EQ(crc32c(data, 9), 0xE3069283u);
+    EXPECT_EQ(crc32c(data + 4, 5, crc32c(data, 4)), 0xE3069283u);
+    EXPECT_EQ(crc32c(data, 0), 0u);
+  }
+  cpuForceTier(cpuDetectedTier());
+}
+
+/**
+ * @brief Tests that frames of any size decode to their values.
+ */
+TEST(VlqFrameTest, RoundTrip) {
+  for (size_t count : {0, 1, 17, 1023, 1024, 1025, 5000}) {
+    const auto values = randomValues(count);
+    const auto encoded = encodeFrame(values);
+    EXPECT_EQ(vlqFrameValueCount(encoded), count);
+
+    // Heap buffer of the exact size, overreads are caught by sanitizers.
+    auto frame = std::make_unique<uint8_t[]>(encoded.size());
+    std::memcpy(frame.get(), encoded.data(), encoded.size());
+    std::vector<uint32_t> decoded(count);
+    auto result =
+        vlqDecodeFrame(std::span(frame.get(), encoded.size()), decoded);
+    EXPECT_EQ(result.status, VlqFrameStatus::kOk);
+    EXPECT_EQ(result.decoded, count);
+    EXPECT_EQ(result.consumed, encoded.size());
+    EXPECT_EQ(decoded, values);
+  }
+}
+
+/**
+ * @brief Tests that short buffers and outputs are reported.
+ */
+TEST(VlqFrameTest, TruncatedAndTooSmall) {
+  const auto values = randomValues(100);
+  const auto frame = encodeFrame(values);
+  std::vector<uint32_t> decoded(values.size());
+  for (size_t size : {size_t{0}, size_t{7}, frame.size() - 1}) {
+    auto buffer = std::make_unique<uint8_t[]>(size);
+    std::memcpy(buffer.get(), frame.data(), size);
+    EXPECT_EQ(vlqDecodeFrame(std::span(buffer.get(), size), decoded).status,
+              VlqFrameStatus::kTruncated);
+  }
+  decoded.resize(values.size() - 1);
+  EXPECT_EQ(vlqDecodeFrame(frame, decoded).status,
+            VlqFrameStatus::kOutputTooSmall);
+}
+
+/**
+ * @brief Tests that flipping any bit of a frame is detected.
+ */
+TEST(VlqFrameTest, CorruptionIsDetected) {
+  const auto values = randomValues(300);
+  const auto frame = encodeFrame(values);
+  std::vector<uint32_t> decoded(1 << 16);
+  for (size_t i = 0; i < frame.size(); i++) {
+    for (int bit : {0, 7}) {
+      // Heap buffer of the exact size: a corrupt header must not make the
+      // decoder read past it.
+      auto buffer = std::make_unique<uint8_t[]>(frame.size());
+      std::memcpy(buffer.get(), frame.data(), frame.size());
+      buffer[i] ^= 1 << bit;
+      const auto status =
+          vlqDecodeFrame(std::span(buffer.get(), frame.size()), decoded)
+              .status;
+      EXPECT_NE(status, VlqFrameStatus::kOk) << "byte " << i << " bit " << bit;
+    }
+  }
+}
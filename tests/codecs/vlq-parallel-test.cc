@@ -0,0 +1,83 @@
+/**
+ * @file vlq-parallel-test.cc
+ * @brief Unit tests for multi-threaded VLQ encoding and decoding.
+ */
+
+// standard includes
+#include <random>
+#include <vector>
+
+// third-party includes
+#include <gtest/gtest.h>
+
+// project includes
+#include "vlq-parallel.h"
+#include "vlq.h"
+
+/**
+ * @brief Tests that the parallel encoder writes what the serial one writes,
+ * and that the parallel decoder reads it back.
+ */
+TEST(VLQParallelTest, MatchesSerial) {
+  std::mt19937 gen(42);
+  std::vector<uint32_t> values(100000);
+  for (auto& value : values) {
+    value = gen() >> (gen() % 32);
+  }
+  std::vector<uint8_t> expected(values.size() * kVlqMaxBytes<uint32_t>);
+  expected.resize(
+      vlqEncodeArray(values.data(), values.size(), expected.data()));
+
+  for (size_t numThreads : {1, 3, 8}) {
+    for (size_t chunkValues : {1000, 4096, 1 << 20}) {
+      std::vector<uint8_t> buffer(expected.size());
+      VlqChunkTable table;
+      size_t size =
+          vlqEncodeArrayParallel(values.data(), values.size(), buffer.data(),
+                                 &table, numThreads, chunkValues);
+      EXPECT_EQ(size, expected.size());
+      EXPECT_EQ(buffer, expected);
+      EXPECT_EQ(table.chunkValues, chunkValues);
+      EXPECT_EQ(table.offsets.size(),
+                (values.size() + chunkValues - 1) / chunkValues + 1);
+
+      std::vector<uint32_t> decoded(values.size());
+      EXPECT_EQ(vlqDecodeArrayParallel(buffer.data(), values.size(),
+                                       decoded.data(), table, numThreads),
+                size);
+      EXPECT_EQ(decoded, values);
+    }
+  }
+}
+
+/**
+ * @brief Tests an empty array.
+ */
+TEST(VLQParallelTest, Empty) {
+  VlqChunkTable table;
+  EXPECT_EQ(vlqEncodeArrayParallel(nullptr, 0, nullptr, &table), 0);
+  EXPECT_EQ(vlqDecodeArrayParallel(nullptr, 0, nullptr, table), 0);
+}
+
+/**
+ * @brief Tests that an empty table or a table of another count is refused
+ * without writing any value.
+ */
+TEST(VLQParallelTest, MismatchedTable) {
+  std::vector<uint32_t> values(10000, 300);
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<uint32_t>);
+  VlqChunkTable table;
+  vlqEncodeArrayParallel(values.data(), values.size(), buffer.data(), &table,
+                         2, 1000);
+
+  std::vector<uint32_t> decoded(values.size(), 7);
+  EXPECT_EQ(vlqDecodeArrayParallel(buffer.data(), values.size(),
+                                   decoded.data(), VlqChunkTable{}),
+            0);
+  for (size_t count : {size_t{0}, size_t{1}, size_t{2500}, size_t{9999}}) {
+    EXPECT_EQ(
+        vlqDecodeArrayParallel(buffer.data(), count, decoded.data(), table),
+        0);
+  }
+  EXPECT_EQ(decoded, std::vector<uint32_t>(values.size(), 7));
+}
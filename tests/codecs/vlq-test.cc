@@ -4,8 +4,14 @@
  */
 
 // standard includes
+#include <algorithm>
+#include <deque>
 #include <format>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
 // third-party includes
 #include <gtest/gtest.h>
 
@@ -83,6 +89,500 @@ TEST(VLQTest, DecodeArray) {
   EXPECT_EQ(values[1], 128);
 }
 
+/**
+ * @brief Encodes random values of up to maxBits bits for the decoder tests.
+ */
+static std::vector<uint8_t> encodeRandom(size_t count, int minBits, int maxBits,
+                                         std::vector<uint32_t>& values) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> bits(minBits, maxBits);
+  values.resize(count);
+  for (auto& value : values) {
+    int width = bits(gen);
+    value = width == 0 ? 0 : gen() >> (32 - width);
+  }
+  std::vector<uint8_t> buffer(count * 5);
+  buffer.resize(vlqEncodeArray(values.data(), count, buffer.data()));
+  return buffer;
+}
+
+/**
+ * @brief Tests that the SIMD decoder matches the scalar decoder.
+ */
+TEST(VLQTest, SimdDecodeMatchesScalar) {
+  const int ranges[][2] = {{0, 7}, {0, 14}, {15, 28}, {0, 32}, {29, 32}};
+  for (const auto& range : ranges) {
+    for (size_t count : {0, 1, 15, 16, 17, 33, 1000}) {
+      std::vector<uint32_t> expected;
+      auto buffer = encodeRandom(count, range[0], range[1], expected);
+      std::vector<uint32_t> scalar(count);
+      std::vector<uint32_t> simd(count);
+
+      EXPECT_EQ(vlqDecodeArrayScalar(buffer.data(), count, scalar.data()),
+                buffer.size());
+      EXPECT_EQ(vlqDecodeArraySimd(buffer.data(), count, simd.data()),
+                buffer.size());
+      EXPECT_EQ(scalar, expected);
+      EXPECT_EQ(simd, scalar);
+    }
+  }
+}
+
+/**
+ * @brief Tests the SIMD decoder on every length boundary.
+ */
+TEST(VLQTest, SimdDecodeBoundaries) {
+  std::vector<uint32_t> expected;
+  for (uint32_t value : {0u, 127u, 128u, 16383u, 16384u, 2097151u, 2097152u,
+                         268435455u, 268435456u, 0xFFFFFFFFu}) {
+    for (int i = 0; i < 20; i++) {
+      expected.push_back(value);
+      expected.push_back(i);
+    }
+  }
+  std::vector<uint8_t> buffer(expected.size() * 5);
+  size_t size = vlqEncodeArray(expected.data(), expected.size(), buffer.data());
+  std::vector<uint32_t> decoded(expected.size());
+
+  EXPECT_EQ(vlqDecodeArraySimd(buffer.data(), expected.size(), decoded.data()),
+            size);
+  EXPECT_EQ(decoded, expected);
+}
+
+/**
+ * @brief Tests the stream decoder with values split across chunks.
+ */
+TEST(VLQTest, StreamDecoderAcrossChunks) {
+  std::vector<uint32_t> expected;
+  auto buffer = encodeRandom(500, 0, 32, expected);
+
+  for (size_t chunkSize : {1, 2, 3, 5, 7, 64, 4096}) {
+    VlqStreamDecoder decoder;
+    std::vector<uint32_t> decoded;
+    uint32_t values[3];
+    for (size_t pos = 0; pos < buffer.size(); pos += chunkSize) {
+      std::span<const uint8_t> chunk(buffer.data() + pos,
+                                     std::min(chunkSize, buffer.size() - pos));
+      while (!chunk.empty()) {
+        auto result = decoder.decode(chunk, values);
+        decoded.insert(decoded.end(), values, values + result.decoded);
+        chunk = chunk.subspan(result.consumed);
+      }
+    }
+    EXPECT_FALSE(decoder.hasPartialValue());
+    EXPECT_EQ(decoded, expected);
+  }
+}
+
+/**
+ * @brief Tests that a truncated value is kept as partial.
+ */
+TEST(VLQTest, StreamDecoderPartialValue) {
+  uint8_t buffer[] = {0x7F, 0x81};
+  uint32_t values[2];
+  VlqStreamDecoder decoder;
+
+  auto result = decoder.decode(buffer, values);
+  EXPECT_EQ(result.consumed, 2);
+  EXPECT_EQ(result.decoded, 1);
+  EXPECT_EQ(values[0], 127);
+  EXPECT_TRUE(decoder.hasPartialValue());
+
+  uint8_t rest[] = {0x00};
+  result = decoder.decode(rest, values);
+  EXPECT_EQ(result.consumed, 1);
+  EXPECT_EQ(result.decoded, 1);
+  EXPECT_EQ(values[0], 128);
+  EXPECT_FALSE(decoder.hasPartialValue());
+
+  decoder.decode(buffer, values);
+  decoder.reset();
+  EXPECT_FALSE(decoder.hasPartialValue());
+}
+
+/**
+ * @brief Tests that the templated codec works in constant expressions.
+ */
+TEST(VLQTest, TemplatedCodecIsConstexpr) {
+  constexpr auto roundTrip = [](uint64_t value) {
+    uint8_t buffer[kVlqMaxBytes<uint64_t>]{};
+    size_t size = vlqEncodeValue(value, buffer);
+    uint64_t decoded = 0;
+    return vlqDecodeValue(buffer, &decoded) == size && decoded == value;
+  };
+  static_assert(roundTrip(0));
+  static_assert(roundTrip(0xFFFFFFFFFFFFFFFFull));
+  static_assert(kVlqMaxBytes<uint16_t> == 3);
+  static_assert(kVlqMaxBytes<uint32_t> == 5);
+  static_assert(kVlqMaxBytes<uint64_t> == 10);
+
+  uint8_t buffer[kVlqMaxBytes<uint64_t>];
+  EXPECT_EQ(vlqEncodeValue<uint64_t>(1ull << 63, buffer), 10);
+  EXPECT_EQ(buffer[0], 0x81);
+  EXPECT_EQ(buffer[9], 0x00);
+  EXPECT_EQ(vlqEncodeValue<uint16_t>(0xFFFF, buffer), 3);
+  EXPECT_EQ(buffer[0], 0x83);
+}
+
+/**
+ * @brief Tests that constant tables are encoded at compile time, to the same
+ * bytes as the runtime encoder.
+ */
+TEST(VLQTest, CompileTimeTables) {
+  constexpr auto kBytes = vlqEncodeTable<std::array{1u, 300u, 70000u}>();
+  static_assert(kBytes.size() == 1 + 2 + 3);
+  static_assert(kBytes[0] == 0x01 && kBytes[1] == 0x82 && kBytes[2] == 0x2C);
+  static_assert(kVlqTable<1, 300, 70000> == kBytes);
+  static_assert(kVlqTable<>.empty());
+
+  constexpr auto kLeb = vlqEncodeTable<std::array<uint64_t, 2>{300, ~0ull},
+                                       VlqOrder::kLsbFirst>();
+  static_assert(kLeb.size() == 2 + kVlqMaxBytes<uint64_t>);
+  static_assert(kLeb[0] == 0xAC && kLeb[1] == 0x02 && kLeb.back() == 0x01);
+
+  uint8_t runtime[3 * kVlqMaxBytes<uint32_t>];
+  const uint32_t fixed[] = {1, 300, 70000};
+  const size_t size = vlqEncodeArray(fixed, 3, runtime);
+  EXPECT_TRUE(
+      std::equal(kBytes.begin(), kBytes.end(), runtime, runtime + size));
+}
+
+/**
+ * @brief Tests the array functions of every width against the scalar path.
+ */
+template <typename T, VlqOrder ORDER = VlqOrder::kMsbFirst>
+static void checkTemplatedRoundTrip() {
+  constexpr int kBits = sizeof(T) * 8;
+  std::mt19937_64 gen(7);
+  std::vector<T> values(2000);
+  for (size_t i = 0; i < values.size(); i++) {
+    int width = gen() % (kBits + 1);
+    values[i] = width == 0 ? 0 : static_cast<T>(gen() >> (64 - width));
+  }
+  std::vector<uint8_t> buffer(values.size() * kVlqMaxBytes<T>);
+  size_t size = vlqEncodeValues<T, ORDER>(values.data(), values.size(),
+                                         buffer.data());
+
+  std::vector<T> scalar(values.size());
+  size_t scalarSize = 0;
+  for (auto& value : scalar) {
+    scalarSize +=
+        vlqDecodeValue<T, ORDER>(buffer.data() + scalarSize, &value);
+  }
+  std::vector<T> decoded(values.size());
+  EXPECT_EQ((vlqDecodeValues<T, ORDER>(buffer.data(), values.size(),
+                                       decoded.data())),
+            size);
+  EXPECT_EQ(scalarSize, size);
+  EXPECT_EQ(scalar, values);
+  EXPECT_EQ(decoded, values);
+}
+
+TEST(VLQTest, TemplatedRoundTrip) {
+  checkTemplatedRoundTrip<uint16_t>();
+  checkTemplatedRoundTrip<uint32_t>();
+  checkTemplatedRoundTrip<uint64_t>();
+  checkTemplatedRoundTrip<uint16_t, VlqOrder::kLsbFirst>();
+  checkTemplatedRoundTrip<uint32_t, VlqOrder::kLsbFirst>();
+  checkTemplatedRoundTrip<uint64_t, VlqOrder::kLsbFirst>();
+}
+
+/**
+ * @brief Tests that the wide-store encoder writes the same bytes.
+ */
+template <VlqOrder ORDER>
+static void checkEncodeWide() {
+  for (int bits = 1; bits <= 64; bits++) {
+    // Smallest and largest values with that bit width, and zero.
+    for (uint64_t value : {1ull << (bits - 1), ~0ull >> (64 - bits), 0ull}) {
+      uint8_t expected[kVlqMaxBytes<uint64_t>];
+      uint8_t wide[kVlqWideStoreBytes<uint64_t>];
+      size_t size = vlqEncodeValue<uint64_t, ORDER>(value, expected);
+      EXPECT_EQ(size, vlqEncodedSize(value));
+      EXPECT_EQ((vlqEncodeValueWide<uint64_t, ORDER>(value, wide)), size);
+      EXPECT_TRUE(std::equal(expected, expected + size, wide)) << value;
+    }
+  }
+}
+
+TEST(VLQTest, EncodeWideMatchesBytewise) {
+  checkEncodeWide<VlqOrder::kMsbFirst>();
+  checkEncodeWide<VlqOrder::kLsbFirst>();
+}
+
+/**
+ * @brief Tests LEB128 against known encodings (protobuf varints, DWARF).
+ */
+TEST(VLQTest, Leb128KnownValues) {
+  const std::pair<uint32_t, std::vector<uint8_t>> cases[] = {
+      {0, {0x00}},
+      {1, {0x01}},
+      {127, {0x7F}},
+      {128, {0x80, 0x01}},
+      {300, {0xAC, 0x02}},
+      {16384, {0x80, 0x80, 0x01}},
+      {624485, {0xE5, 0x8E, 0x26}},
+      {0xFFFFFFFF, {0xFF, 0xFF, 0xFF, 0xFF, 0x0F}},
+  };
+  for (const auto& [value, expected] : cases) {
+    uint8_t buffer[kVlqMaxBytes<uint32_t>];
+    size_t size = leb128Encode(value, buffer);
+    EXPECT_EQ(std::vector<uint8_t>(buffer, buffer + size), expected) << value;
+
+    uint32_t decoded = 0;
+    EXPECT_EQ(leb128Decode(expected.data(), &decoded), expected.size());
+    EXPECT_EQ(decoded, value);
+  }
+
+  static_assert([] {
+    uint8_t buffer[kVlqMaxBytes<uint64_t>]{};
+    vlqEncodeValue<uint64_t, VlqOrder::kLsbFirst>(300, buffer);
+    return buffer[0] == 0xAC && buffer[1] == 0x02;
+  }());
+}
+
+/**
+ * @brief Tests the LEB128 array and SIMD decoders against the scalar one.
+ */
+TEST(VLQTest, Leb128SimdDecodeMatchesScalar) {
+  const int ranges[][2] = {{0, 7}, {0, 14}, {15, 28}, {0, 32}, {29, 32}};
+  for (const auto& range : ranges) {
+    for (size_t count : {0, 1, 15, 16, 17, 33, 1000}) {
+      std::vector<uint32_t> expected;
+      encodeRandom(count, range[0], range[1], expected);
+      std::vector<uint8_t> buffer(count * kVlqMaxBytes<uint32_t>);
+      buffer.resize(leb128EncodeArray(expected.data(), count, buffer.data()));
+      EXPECT_EQ(buffer.size(), vlqEncodedSizeArray(expected.data(), count));
+
+      std::vector<uint32_t> scalar(count);
+      size_t scalarSize = 0;
+      for (auto& value : scalar) {
+        scalarSize += leb128Decode(buffer.data() + scalarSize, &value);
+      }
+      std::vector<uint32_t> simd(count);
+      EXPECT_EQ(leb128DecodeArray(buffer.data(), count, simd.data()),
+                buffer.size());
+      EXPECT_EQ(scalarSize, buffer.size());
+      EXPECT_EQ(scalar, expected);
+      EXPECT_EQ(simd, expected);
+    }
+  }
+}
+
+/**
+ * @brief Tests the LEB128 stream decoder with values split across chunks.
+ */
+TEST(VLQTest, Leb128StreamDecoderAcrossChunks) {
+  std::vector<uint32_t> expected;
+  encodeRandom(500, 0, 32, expected);
+  std::vector<uint8_t> buffer(expected.size() * kVlqMaxBytes<uint32_t>);
+  buffer.resize(
+      leb128EncodeArray(expected.data(), expected.size(), buffer.data()));
+
+  for (size_t chunkSize : {1, 2, 3, 5, 7, 64, 4096}) {
+    Leb128StreamDecoder decoder;
+    std::vector<uint32_t> decoded;
+    uint32_t values[3];
+    for (size_t pos = 0; pos < buffer.size(); pos += chunkSize) {
+      std::span<const uint8_t> chunk(buffer.data() + pos,
+                                     std::min(chunkSize, buffer.size() - pos));
+      while (!chunk.empty()) {
+        auto result = decoder.decode(chunk, values);
+        decoded.insert(decoded.end(), values, values + result.decoded);
+        chunk = chunk.subspan(result.consumed);
+      }
+    }
+    EXPECT_FALSE(decoder.hasPartialValue());
+    EXPECT_EQ(decoded, expected);
+  }
+}
+
+/**
+ * @brief Tests that the array encoder writes nothing past the encoded data.
+ */
+TEST(VLQTest, EncodeArrayExactBuffer) {
+  std::vector<uint32_t> values;
+  auto expected = encodeRandom(100, 0, 32, values);
+  size_t size = 0;
+  for (uint32_t value : values) {
+    size += vlqEncodedSize(value);
+  }
+  ASSERT_EQ(size, expected.size());
+
+  // Heap buffer of the exact size, overruns are caught by sanitizers.
+  auto buffer = std::make_unique<uint8_t[]>(size);
+  EXPECT_EQ(vlqEncodeArray(values.data(), values.size(), buffer.get()), size);
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), buffer.get()));
+}
+
+/**
+ * @brief Tests the encoded size of arrays against the encoder.
+ */
+TEST(VLQTest, EncodedSizeArray) {
+  for (size_t count : {0, 3, 4, 5, 1000}) {
+    std::vector<uint32_t> values;
+    auto buffer = encodeRandom(count, 0, 32, values);
+    EXPECT_EQ(vlqEncodedSizeArray(values.data(), count), buffer.size());
+
+    std::vector<uint64_t> wide(values.begin(), values.end());
+    for (size_t i = 0; i < count; i += 3) {
+      wide[i] = wide[i] << 32 | wide[i];
+    }
+    std::vector<uint8_t> wideBuffer(count * kVlqMaxBytes<uint64_t>);
+    EXPECT_EQ(vlqEncodedSizeArray(wide.data(), count),
+              vlqEncodeValues(wide.data(), count, wideBuffer.data()));
+  }
+}
+
+/**
+ * @brief Tests that checked encoders stop at the first value that does not
+ * fit, and that the rest can be encoded into another buffer.
+ */
+TEST(VLQTest, EncodeChecked) {
+  uint8_t small[1];
+  EXPECT_EQ(vlqEncodeChecked(128, small), 0);
+  EXPECT_EQ(vlqEncodeChecked(127, small), 1);
+  EXPECT_EQ(small[0], 0x7F);
+
+  std::vector<uint32_t> values;
+  auto expected = encodeRandom(200, 0, 32, values);
+  for (size_t capacity : {0, 1, 7, 8, 9, 100}) {
+    std::vector<uint8_t> output;
+    size_t encoded = 0;
+    while (encoded < values.size()) {
+      auto buffer = std::make_unique<uint8_t[]>(capacity);
+      auto result = vlqEncodeArrayChecked(values.data() + encoded,
+                                          values.size() - encoded,
+                                          std::span(buffer.get(), capacity));
+      EXPECT_LE(result.written, capacity);
+      if (result.encoded == 0) {
+        break;  // Buffer too small for the next value
+      }
+      output.insert(output.end(), buffer.get(),
+                    buffer.get() + result.written);
+      encoded += result.encoded;
+    }
+    if (capacity >= kVlqMaxBytes<uint32_t>) {
+      EXPECT_EQ(encoded, values.size());
+      EXPECT_EQ(output, expected);
+    }
+  }
+}
+
+/**
+ * @brief Tests value counting on every alignment of the buffer tail.
+ */
+TEST(VLQTest, CountValues) {
+  for (size_t count : {0, 1, 15, 16, 17, 63, 64, 65, 1000}) {
+    std::vector<uint32_t> values;
+    auto buffer = encodeRandom(count, 0, 32, values);
+    EXPECT_EQ(vlqCountValues(buffer.data(), buffer.size()), count);
+    if (count > 0) {
+      // The cut last value is not counted.
+      const size_t last = vlqEncodedSize(values.back());
+      for (size_t cut = 1; cut < last; cut++) {
+        EXPECT_EQ(vlqCountValues(buffer.data(), buffer.size() - cut),
+                  count - 1);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Tests the decode bounded by the buffer length, with and without a
+ * truncated last value.
+ */
+TEST(VLQTest, DecodeArrayUntilEnd) {
+  for (size_t count : {0, 1, 16, 17, 33, 1000}) {
+    std::vector<uint32_t> expected;
+    auto encoded = encodeRandom(count, 0, 32, expected);
+    // Heap buffers of the exact size, overreads are caught by sanitizers.
+    for (size_t cut : {0, 1}) {
+      if (cut > encoded.size()) {
+        continue;
+      }
+      const size_t size = encoded.size() - cut;
+      auto buffer = std::make_unique<uint8_t[]>(size);
+      std::copy_n(encoded.begin(), size, buffer.get());
+      std::vector<uint32_t> decoded(count);
+
+      auto result = vlqDecodeArrayUntilEnd(std::span(buffer.get(), size),
+                                           decoded);
+      const bool truncated = cut > 0 && vlqEncodedSize(expected.back()) > 1;
+      EXPECT_EQ(result.truncated, truncated);
+      EXPECT_EQ(result.decoded, count - cut);
+      decoded.resize(result.decoded);
+      EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(),
+                             expected.begin()));
+      EXPECT_EQ(result.consumed,
+                truncated ? size - (vlqEncodedSize(expected.back()) - 1)
+                          : size);
+    }
+  }
+
+  // A full output span stops the decode at a value boundary.
+  std::vector<uint32_t> expected;
+  auto buffer = encodeRandom(100, 0, 32, expected);
+  std::vector<uint32_t> decoded(40);
+  auto result = vlqDecodeArrayUntilEnd(buffer, decoded);
+  EXPECT_EQ(result.decoded, 40);
+  EXPECT_FALSE(result.truncated);
+  EXPECT_EQ(result.consumed,
+            vlqEncodedSizeArray(expected.data(), result.decoded));
+  EXPECT_TRUE(std::equal(decoded.begin(), decoded.end(), expected.begin()));
+}
+
+/**
+ * @brief Growable buffer without reserve(), as a user type could be.
+ */
+struct PlainBuffer {
+  std::unique_ptr<uint8_t[]> bytes;
+  size_t used{0};
+
+  uint8_t* data() { return bytes.get(); }
+  size_t size() const { return used; }
+  void resize(size_t size) {
+    auto grown = std::make_unique<uint8_t[]>(size);
+    std::copy_n(bytes.get(), std::min(used, size), grown.get());
+    bytes = std::move(grown);
+    used = size;
+  }
+};
+
+/**
+ * @brief Tests the appending and output-iterator encoders against the
+ * array encoder.
+ */
+TEST(VLQTest, AppendEncoders) {
+  for (size_t count : {0, 1, 255, 256, 257, 1000}) {
+    std::vector<uint32_t> values;
+    auto expected = encodeRandom(count, 0, 32, values);
+
+    std::vector<uint8_t> vector = {0xAA};
+    EXPECT_EQ(vlqEncodeArray(values.data(), count, vector), expected.size());
+    ASSERT_EQ(vector.size(), expected.size() + 1);
+    EXPECT_EQ(vector[0], 0xAA);
+    EXPECT_TRUE(
+        std::equal(expected.begin(), expected.end(), vector.begin() + 1));
+
+    PlainBuffer plain;
+    EXPECT_EQ(vlqAppendValues(values.data(), count, plain), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), plain.data()));
+
+    std::deque<uint8_t> deque;
+    vlqEncodeValuesTo(values.data(), count, std::back_inserter(deque));
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), deque.begin(),
+                           deque.end()));
+  }
+
+  std::vector<uint16_t> narrow = {0, 127, 128, 65535};
+  std::vector<uint8_t> leb;
+  vlqAppendValues<uint16_t, VlqOrder::kLsbFirst>(narrow.data(), narrow.size(),
+                                                 leb);
+  EXPECT_EQ(leb, (std::vector<uint8_t>{0x00, 0x7F, 0x80, 0x01, 0xFF, 0xFF,
+                                       0x03}));
+}
+
 /**
  * @brief Main function to execute all Google Test cases.
  *
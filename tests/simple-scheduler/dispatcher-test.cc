@@ -0,0 +1,74 @@
+#include "dispatcher.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "scheduler.h"
+#include "timing-wheel.h"
+
+namespace scheduler {
+
+// Test that the dispatcher hands ready tasks to its workers
+TEST(DispatcherTest, RunsReadyTasksOnItsWorkers) {
+  const TimePoint now = Clock::now();
+  auto tasks = std::make_shared<Scheduler>();
+  std::atomic<int> count{0};
+  for (int i = 0; i < 100; i++) {
+    tasks->scheduleFunction([&count]() { count++; }, now);
+  }
+  tasks->scheduleFunction([&count]() { count += 1000; },
+                          now + std::chrono::seconds(10));
+
+  Dispatcher<Scheduler> dispatcher(2);
+  EXPECT_TRUE(dispatcher.spawnReady(now, tasks));
+  dispatcher.stop(true);
+  EXPECT_EQ(count.load(), 100);
+  EXPECT_EQ(tasks->getNumPendingTasks(), 1);
+}
+
+// Test that a draining stop runs the tasks handed to the workers, and a
+// plain stop drops those not yet started
+TEST(DispatcherTest, StopDrainRunsInFlightTasks) {
+  using namespace std::chrono_literals;
+  for (const bool drain : {true, false}) {
+    const TimePoint now = Clock::now();
+    auto tasks = std::make_shared<Scheduler>();
+    std::atomic<bool> started{false};
+    std::atomic<int> count{0};
+    tasks->scheduleFunction(
+        [&started]() {
+          started = true;
+          std::this_thread::sleep_for(50ms);
+        },
+        now);
+    for (int i = 0; i < 10; i++) {
+      tasks->scheduleFunction([&count]() { count++; }, now + 1ns);
+    }
+
+    Dispatcher<Scheduler> dispatcher(1);
+    EXPECT_TRUE(dispatcher.spawnReady(now + 1ns, tasks));
+    while (!started) {
+      std::this_thread::yield();
+    }
+    dispatcher.stop(drain);
+    EXPECT_EQ(count.load(), drain ? 10 : 0);
+    EXPECT_EQ(dispatcher.getNumInFlightTasks(), 0);
+  }
+}
+
+// Test that the dispatcher runs tasks from the wheel backend
+TEST(DispatcherTest, UsesWheelBackend) {
+  auto tasks = std::make_shared<TimingWheelScheduler>();
+  std::atomic<int> count{0};
+  for (int i = 0; i < 100; i++) {
+    tasks->scheduleFunction([&count]() { count++; }, Clock::now());
+  }
+  Dispatcher<TimingWheelScheduler> dispatcher(2);
+  EXPECT_TRUE(dispatcher.spawnReady(Clock::now(), tasks));
+  dispatcher.stop(true);
+  EXPECT_EQ(count.load(), 100);
+}
+
+}  // namespace scheduler
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "dispatcher.h"
+#include "scheduler.h"
+#include "timing-wheel.h"
+
+namespace scheduler {
+
+// Time point the given number of clock ticks after the clock's epoch
+TimePoint at(int64_t ticks) {
+  return TimePoint{} + Clock::duration{ticks};
+}
+
+// Both backends must behave the same behind the scheduler interface
+template <typename SCHEDULER>
+class SchedulerBackendTest : public ::testing::Test {
+ protected:
+  SCHEDULER scheduler;
+};
+
+using Backends = ::testing::Types<Scheduler, TimingWheelScheduler>;
+TYPED_TEST_SUITE(SchedulerBackendTest, Backends);
+
+// Test that functions are popped at their time, not earlier
+TYPED_TEST(SchedulerBackendTest, PopsAtExpirationTime) {
+  int executed = 0;
+  this->scheduler.scheduleFunction([&]() { executed += 1; }, at(100));
+  this->scheduler.scheduleFunction([&]() { executed += 10; }, at(5000));
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 2);
+
+  EXPECT_TRUE(this->scheduler.popReady(at(99)).empty());
+  auto ready = this->scheduler.popReady(at(100));
+  ASSERT_EQ(ready.size(), 1);
+  ready[0]();
+  EXPECT_EQ(executed, 1);
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 1);
+
+  ready = this->scheduler.popReady(at(100000));
+  ASSERT_EQ(ready.size(), 1);
+  ready[0]();
+  EXPECT_EQ(executed, 11);
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 0);
+}
+
+// Test that a function scheduled in the past is ready at once
+TYPED_TEST(SchedulerBackendTest, PastExpirationIsReadyAtOnce) {
+  EXPECT_TRUE(this->scheduler.popReady(at(1000)).empty());
+  this->scheduler.scheduleFunction([]() {}, at(10));
+  EXPECT_EQ(this->scheduler.popReady(at(1000)).size(), 1);
+}
+
+// Test that a cancelled task is destroyed at once and never popped
+TYPED_TEST(SchedulerBackendTest, CancelDropsTask) {
+  auto resource = std::make_shared<int>(0);
+  std::vector<int> fired;
+  this->scheduler.scheduleFunction([&]() { fired.push_back(1); }, at(100));
+  const TaskHandle handle = this->scheduler.scheduleFunction(
+      [&fired, resource]() { fired.push_back(2); }, at(200));
+  this->scheduler.scheduleFunction([&]() { fired.push_back(3); }, at(300));
+  EXPECT_EQ(resource.use_count(), 2);
+
+  EXPECT_TRUE(this->scheduler.cancel(handle));
+  EXPECT_EQ(resource.use_count(), 1);
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 2);
+  EXPECT_FALSE(this->scheduler.cancel(handle));
+
+  for (const auto& func : this->scheduler.popReady(at(1000))) {
+    func();
+  }
+  EXPECT_EQ(fired, std::vector<int>({1, 3}));
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 0);
+}
+
+// Test that a closure destroyed by cancel() may call back into the scheduler
+TYPED_TEST(SchedulerBackendTest, CancelDestroysClosureUnlocked) {
+  const TaskHandle other = this->scheduler.scheduleFunction([]() {}, at(100));
+  std::shared_ptr<void> onDestroy(nullptr, [this, other](void*) {
+    EXPECT_TRUE(this->scheduler.cancel(other));
+  });
+  const TaskHandle handle = this->scheduler.scheduleFunction(
+      [onDestroy]() {}, at(200));
+  onDestroy.reset();
+
+  EXPECT_TRUE(this->scheduler.cancel(handle));
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 0);
+}
+
+// Test that handles of tasks that ran or whose slot was reused do nothing
+TYPED_TEST(SchedulerBackendTest, CancelIgnoresOldHandles) {
+  const TaskHandle ran = this->scheduler.scheduleFunction([]() {}, at(10));
+  EXPECT_EQ(this->scheduler.popReady(at(10)).size(), 1);
+  EXPECT_FALSE(this->scheduler.cancel(ran));
+  EXPECT_FALSE(this->scheduler.cancel(TaskHandle{}));
+
+  // The next task may take the slot of the one that ran.
+  const TaskHandle reused = this->scheduler.scheduleFunction([]() {}, at(20));
+  EXPECT_FALSE(this->scheduler.cancel(ran));
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 1);
+  EXPECT_TRUE(this->scheduler.cancel(reused));
+}
+
+// Test that cancelling most timeouts keeps the rest in order
+TYPED_TEST(SchedulerBackendTest, CancelManyKeepsOthers) {
+  std::mt19937 gen(42);
+  std::vector<TaskHandle> handles;
+  std::vector<int64_t> fired;
+  for (int i = 0; i < 10000; i++) {
+    const int64_t deadline = 1 + gen() % 1000000;
+    handles.push_back(this->scheduler.scheduleFunction(
+        [&fired, deadline]() { fired.push_back(deadline); }, at(deadline)));
+  }
+  for (size_t i = 0; i < handles.size(); i++) {
+    if (i % 10 != 0) {
+      EXPECT_TRUE(this->scheduler.cancel(handles[i]));
+    }
+  }
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 1000);
+
+  for (int64_t now = 0; now <= 1000000; now += 50000) {
+    for (const auto& func : this->scheduler.popReady(at(now))) {
+      func();
+    }
+  }
+  EXPECT_EQ(fired.size(), 1000);
+  EXPECT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+  EXPECT_EQ(this->scheduler.getNumPendingTasks(), 0);
+}
+
+// Test that waitUntilReady() sleeps until a task is due, or is stopped
+TYPED_TEST(SchedulerBackendTest, WaitUntilReadySleepsUntilDeadline) {
+  using namespace std::chrono_literals;
+  std::atomic<bool> stopFlag{false};
+  const TimePoint deadline = Clock::now() + 20ms;
+  this->scheduler.scheduleFunction([]() {}, deadline);
+
+  // The wheel may also wake for a cascade before the deadline.
+  std::vector<ScheduledFunction> ready;
+  while (ready.empty()) {
+    this->scheduler.waitUntilReady(stopFlag);
+    ready = this->scheduler.popReady(Clock::now());
+  }
+  EXPECT_GE(Clock::now(), deadline);
+
+  stopFlag = true;
+  this->scheduler.scheduleFunction([]() {}, Clock::now() + 1h);
+  this->scheduler.waitUntilReady(stopFlag);
+}
+
+// Test that a sleeping dispatcher wakes for an earlier deadline and stop()
+TYPED_TEST(SchedulerBackendTest, DispatcherWakesForEarlierDeadline) {
+  using namespace std::chrono_literals;
+  auto tasks = std::make_shared<TypeParam>();
+  std::atomic<bool> late{false};
+  std::atomic<bool> early{false};
+  Dispatcher<TypeParam> dispatcher(1);
+  dispatcher.launch(tasks);
+  tasks->scheduleFunction([&late]() { late = true; }, Clock::now() + 1h);
+  std::this_thread::sleep_for(10ms);
+
+  const TimePoint deadline = Clock::now() + 5ms;
+  tasks->scheduleFunction([&early]() { early = true; }, deadline);
+  while (!early.load() && Clock::now() < deadline + 5s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_TRUE(early.load());
+  EXPECT_FALSE(late.load());
+
+  const TimePoint stopping = Clock::now();
+  dispatcher.stop();
+  EXPECT_LT(Clock::now() - stopping, 1s);
+}
+
+// Test that a launched dispatcher releases a scheduler dropped by its owner,
+// even while sleeping with only a far deadline pending
+TYPED_TEST(SchedulerBackendTest, DispatcherExitsOnceSchedulerDropped) {
+  using namespace std::chrono_literals;
+  auto tasks = std::make_shared<TypeParam>();
+  const std::weak_ptr<TypeParam> owned = tasks;
+  Dispatcher<TypeParam> dispatcher(1);
+  dispatcher.launch(tasks);
+  tasks->scheduleFunction([]() {}, Clock::now() + 1h);
+  std::this_thread::sleep_for(10ms);
+
+  const TimePoint dropped = Clock::now();
+  tasks.reset();
+  while (!owned.expired() && Clock::now() < dropped + 5s) {
+    std::this_thread::sleep_for(1ms);
+  }
+  EXPECT_TRUE(owned.expired());
+  EXPECT_LT(Clock::now() - dropped, 1s);
+
+  // The runner has exited: stop() only joins it.
+  const TimePoint stopping = Clock::now();
+  dispatcher.stop();
+  EXPECT_LT(Clock::now() - stopping, 1s);
+}
+
+}  // namespace scheduler
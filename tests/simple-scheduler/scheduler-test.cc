@@ -2,21 +2,29 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <chrono>
+#include <vector>
 
 namespace scheduler {
 
 // Mockable clock class
 class MockClock {
  public:
-  MOCK_METHOD(std::time_t, now, (), (const));
+  MOCK_METHOD(TimePoint, now, (), (const));
 };
 
 // Global mock clock instance
 MockClock* global_mock_clock = nullptr;
 
-// Replacement for std::time(nullptr)
-std::time_t mock_time() {
-  return global_mock_clock ? global_mock_clock->now() : std::time(nullptr);
+// Replacement for Clock::now()
+TimePoint mock_time() {
+  return global_mock_clock ? global_mock_clock->now() : Clock::now();
+}
+
+// Time point the given number of milliseconds after the clock's epoch
+TimePoint at(double milliseconds) {
+  return TimePoint{} + std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double, std::milli>(
+                               milliseconds));
 }
 
 // Test Fixture for Scheduler
@@ -32,20 +40,20 @@ class SchedulerTest : public ::testing::Test {
 
 // Test scheduling a function and checking pending task count
 TEST_F(SchedulerTest, ScheduleFunctionIncreasesPendingTasks) {
-  scheduler.scheduleFunction([]() {}, 100);
+  scheduler.scheduleFunction([]() {}, at(100));
   EXPECT_EQ(scheduler.getNumPendingTasks(), 1);
 }
 
 // Test popping a scheduled function when it's ready
 TEST_F(SchedulerTest, PopReadyReturnsScheduledFunction) {
   bool executed = false;
-  scheduler.scheduleFunction([&executed]() { executed = true; }, 100);
+  scheduler.scheduleFunction([&executed]() { executed = true; }, at(100));
 
   // Mock time progression
-  EXPECT_CALL(mockClock, now()).WillRepeatedly(testing::Return(100));
+  EXPECT_CALL(mockClock, now()).WillRepeatedly(testing::Return(at(100)));
 
   // Pop the ready function
-  auto readyFunctions = scheduler.popReady(100);
+  auto readyFunctions = scheduler.popReady(at(100));
 
   ASSERT_EQ(readyFunctions.size(), 1);
   readyFunctions[0]();  // Execute the function
@@ -55,10 +63,10 @@ TEST_F(SchedulerTest, PopReadyReturnsScheduledFunction) {
 // Test that function is not popped too early
 TEST_F(SchedulerTest, PopReadyDoesNotReturnFunctionTooEarly) {
   bool executed = false;
-  scheduler.scheduleFunction([&executed]() { executed = true; }, 500);
+  scheduler.scheduleFunction([&executed]() { executed = true; }, at(500));
 
   // Attempt to pop functions before they are due
-  auto readyFunctions = scheduler.popReady(499);
+  auto readyFunctions = scheduler.popReady(at(499));
 
   EXPECT_TRUE(readyFunctions.empty());
 }
@@ -66,22 +74,76 @@ TEST_F(SchedulerTest, PopReadyDoesNotReturnFunctionTooEarly) {
 // Test scheduling multiple functions with different absolute times
 TEST_F(SchedulerTest, MultipleFunctionsAreScheduledAndExecutedInOrder) {
   std::vector<int> executionOrder;
-  scheduler.scheduleFunction([&]() { executionOrder.push_back(1); }, 1000);
-  scheduler.scheduleFunction([&]() { executionOrder.push_back(2); }, 2000);
-  scheduler.scheduleFunction([&]() { executionOrder.push_back(2); }, 3000);
+  scheduler.scheduleFunction([&]() { executionOrder.push_back(1); }, at(1000));
+  scheduler.scheduleFunction([&]() { executionOrder.push_back(2); }, at(2000));
+  scheduler.scheduleFunction([&]() { executionOrder.push_back(2); }, at(3000));
 
-  auto firstBatch = scheduler.popReady(1000);
+  auto firstBatch = scheduler.popReady(at(1000));
   ASSERT_EQ(firstBatch.size(), 1);
   firstBatch[0]();
 
-  auto secondBatch = scheduler.popReady(2001);
+  auto secondBatch = scheduler.popReady(at(2001));
   ASSERT_EQ(secondBatch.size(), 1);
   secondBatch[0]();
 
-  auto thirdBatch = scheduler.popReady(2999);
+  auto thirdBatch = scheduler.popReady(at(2999));
   ASSERT_EQ(thirdBatch.size(), 0);
 
   EXPECT_EQ(executionOrder, std::vector<int>({1, 2}));
 }
 
+// Test that deadlines are kept to the sub-millisecond
+TEST_F(SchedulerTest, PopReadyHasSubMillisecondPrecision) {
+  scheduler.scheduleFunction([]() {}, at(100.5));
+
+  EXPECT_TRUE(scheduler.popReady(at(100.499)).empty());
+  EXPECT_EQ(scheduler.popReady(at(100.5)).size(), 1);
+}
+
+// Test that a cancelled task is neither counted nor popped
+TEST_F(SchedulerTest, CancelRemovesPendingTask) {
+  bool executed = false;
+  const TaskHandle handle =
+      scheduler.scheduleFunction([&executed]() { executed = true; }, at(100));
+  scheduler.scheduleFunction([]() {}, at(200));
+
+  EXPECT_TRUE(scheduler.cancel(handle));
+  EXPECT_EQ(scheduler.getNumPendingTasks(), 1);
+  EXPECT_TRUE(scheduler.popReady(at(199)).empty());
+  EXPECT_EQ(scheduler.popReady(at(200)).size(), 1);
+  EXPECT_FALSE(executed);
+  EXPECT_EQ(scheduler.getNumPendingTasks(), 0);
+  EXPECT_FALSE(scheduler.cancel(handle));
+}
+
+// Test that the stale heap entry of a cancelled task does not pop the task
+// reusing its slot at the old deadline
+TEST_F(SchedulerTest, CancelledEntryDoesNotPopReusedSlot) {
+  const TaskHandle cancelled = scheduler.scheduleFunction([]() {}, at(100));
+  EXPECT_TRUE(scheduler.cancel(cancelled));
+  const TaskHandle reused = scheduler.scheduleFunction([]() {}, at(500));
+  EXPECT_EQ(reused.slot, cancelled.slot);
+
+  EXPECT_TRUE(scheduler.popReady(at(100)).empty());
+  EXPECT_EQ(scheduler.getNumPendingTasks(), 1);
+  EXPECT_EQ(scheduler.popReady(at(500)).size(), 1);
+}
+
+// Test that cancelling most tasks, which rebuilds the heap, keeps the rest
+TEST_F(SchedulerTest, CancelManyRebuildsHeap) {
+  std::vector<TaskHandle> handles;
+  for (int i = 0; i < 1000; i++) {
+    handles.push_back(scheduler.scheduleFunction([]() {}, at(1000 - i)));
+  }
+  for (size_t i = 0; i < handles.size(); i++) {
+    if (i % 100 != 0) {
+      EXPECT_TRUE(scheduler.cancel(handles[i]));
+    }
+  }
+  EXPECT_EQ(scheduler.getNumPendingTasks(), 10);
+  EXPECT_EQ(scheduler.popReady(at(500)).size(), 5);
+  EXPECT_EQ(scheduler.popReady(at(1000)).size(), 5);
+  EXPECT_EQ(scheduler.getNumPendingTasks(), 0);
+}
+
 }  // namespace scheduler
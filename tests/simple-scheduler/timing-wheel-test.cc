@@ -0,0 +1,78 @@
+#include "timing-wheel.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "scheduler.h"
+
+namespace scheduler {
+
+// Time point the given number of clock ticks after the clock's epoch
+TimePoint at(int64_t ticks) {
+  return TimePoint{} + Clock::duration{ticks};
+}
+
+// Test that both backends pop the same tasks, in deadline order, for
+// deadlines spread over every level of the wheel
+TEST(TimingWheelTest, MatchesHeapScheduler) {
+  Scheduler heap;
+  TimingWheelScheduler wheel;
+  std::mt19937_64 gen(42);
+  std::vector<TimePoint> fired;
+  TimePoint now{};
+  for (int round = 0; round < 200; round++) {
+    for (int i = 0; i < 50; i++) {
+      const int width = gen() % 40;
+      const TimePoint deadline =
+          now + Clock::duration(gen() & ((uint64_t{1} << width) - 1));
+      heap.scheduleFunction([]() {}, deadline);
+      wheel.scheduleFunction(
+          [&fired, deadline]() { fired.push_back(deadline); }, deadline);
+    }
+    now += Clock::duration(gen() % 5000);
+    const auto fromHeap = heap.popReady(now);
+    const auto fromWheel = wheel.popReady(now);
+    ASSERT_EQ(fromHeap.size(), fromWheel.size()) << "round " << round;
+    ASSERT_EQ(heap.getNumPendingTasks(), wheel.getNumPendingTasks());
+
+    fired.clear();
+    for (const auto& func : fromWheel) {
+      func();
+    }
+    EXPECT_TRUE(std::is_sorted(fired.begin(), fired.end()));
+    for (TimePoint deadline : fired) {
+      EXPECT_LE(deadline, now);
+    }
+  }
+  const TimePoint end = now + Clock::duration(int64_t{1} << 40);
+  EXPECT_EQ(heap.popReady(end).size(), wheel.popReady(end).size());
+  EXPECT_EQ(wheel.getNumPendingTasks(), 0);
+}
+
+// Test that tasks of equal deadline keep their scheduling order
+TEST(TimingWheelTest, EqualDeadlinesKeepOrder) {
+  TimingWheelScheduler wheel;
+  std::vector<int> order;
+  for (int i = 0; i < 5; i++) {
+    wheel.scheduleFunction([&order, i]() { order.push_back(i); },
+                           at(70000));
+  }
+  for (const auto& func : wheel.popReady(at(70000))) {
+    func();
+  }
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+// Test that a coarse tick fires late rather than early
+TEST(TimingWheelTest, CoarseTickNeverFiresEarly) {
+  using std::chrono::microseconds;
+  TimingWheelScheduler wheel(std::chrono::milliseconds(1));
+  wheel.scheduleFunction([]() {}, TimePoint{} + microseconds(100500));
+
+  EXPECT_TRUE(wheel.popReady(TimePoint{} + microseconds(100500)).empty());
+  EXPECT_TRUE(wheel.popReady(TimePoint{} + microseconds(100999)).empty());
+  EXPECT_EQ(wheel.popReady(TimePoint{} + microseconds(101000)).size(), 1);
+}
+
+}  // namespace scheduler
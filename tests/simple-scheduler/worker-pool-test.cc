@@ -0,0 +1,81 @@
+#include "worker-pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <set>
+
+#include "scheduler.h"
+
+namespace scheduler {
+
+// Test that every submitted function runs
+TEST(WorkerPoolTest, RunsEveryFunction) {
+  WorkerPool pool(4);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(pool.submit([&count]() { count++; }));
+  }
+  std::vector<ScheduledFunction> batch(1000, [&count]() { count++; });
+  EXPECT_TRUE(pool.submit(std::move(batch)));
+
+  pool.waitIdle();
+  EXPECT_EQ(count.load(), 2000);
+  EXPECT_EQ(pool.getNumInFlightTasks(), 0);
+}
+
+// Test that functions run on the pool's threads only
+TEST(WorkerPoolTest, RunsOnAFixedSetOfThreads) {
+  WorkerPool pool(3);
+  std::mutex mtx;
+  std::set<std::thread::id> threads;
+  for (int i = 0; i < 500; i++) {
+    pool.submit([&]() {
+      std::lock_guard<std::mutex> guard(mtx);
+      threads.insert(std::this_thread::get_id());
+    });
+  }
+  pool.waitIdle();
+  EXPECT_EQ(pool.getNumWorkers(), 3);
+  EXPECT_LE(threads.size(), 3);
+  EXPECT_EQ(threads.count(std::this_thread::get_id()), 0);
+}
+
+// Test that a draining stop runs the queued functions
+TEST(WorkerPoolTest, StopDrainRunsQueuedFunctions) {
+  using namespace std::chrono_literals;
+  WorkerPool pool(1);
+  std::atomic<int> count{0};
+  pool.submit([]() { std::this_thread::sleep_for(50ms); });
+  for (int i = 0; i < 10; i++) {
+    pool.submit([&count]() { count++; });
+  }
+  pool.stop(true);
+  EXPECT_EQ(count.load(), 10);
+  EXPECT_FALSE(pool.submit([]() {}));
+}
+
+// Test that a plain stop waits for the running function only
+TEST(WorkerPoolTest, StopDropsQueuedFunctions) {
+  using namespace std::chrono_literals;
+  WorkerPool pool(1);
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  std::atomic<int> count{0};
+  pool.submit([&]() {
+    started = true;
+    std::this_thread::sleep_for(50ms);
+    finished = true;
+  });
+  for (int i = 0; i < 10; i++) {
+    pool.submit([&count]() { count++; });
+  }
+  while (!started) {
+    std::this_thread::yield();
+  }
+  pool.stop();
+  EXPECT_TRUE(finished.load());
+  EXPECT_EQ(count.load(), 0);
+  EXPECT_EQ(pool.getNumInFlightTasks(), 0);
+}
+
+}  // namespace scheduler